@@ -0,0 +1,86 @@
+/*
+ *             Copyright [2025] [samllin]
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *        http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+
+// 对比默认配置与CONFIG_MYNVS_FAST_PATH下每次调用的耗时，分别编译运行后比较输出
+// 成功路径反映校验/加锁开销，失败路径反映日志开销
+
+#include <stdio.h>
+#include "sdkconfig.h"
+#include "esp_log.h"
+#include "esp_timer.h"
+#include "my_nvs.hpp"
+#include "my_nvs_log.hpp"
+
+#define TAG "benchmark"
+
+#define ITERATIONS  2000
+
+#if CONFIG_MYNVS_FAST_PATH
+#define PROFILE     "精简路径"
+#else
+#define PROFILE     "默认配置"
+#endif
+
+template <typename F>
+static void measure(const char* name, F&& call)
+{
+    // 预热一次，排除首次访问的页面缓存影响
+    call();
+    int64_t start = esp_timer_get_time();
+    for (int i = 0; i < ITERATIONS; i++) {
+        call();
+    }
+    int64_t elapsed = esp_timer_get_time() - start;
+    printf("%-24s %8.2f us/call\n", name, static_cast<double>(elapsed) / ITERATIONS);
+}
+
+extern "C" void app_main(void)
+{
+    MyNVS nvs("bench", NVS_READWRITE);
+    MyNVS ro("bench", NVS_READONLY);
+    nvs.write("u32", 0x12345678u);
+    nvs.write("i64", -1LL);
+    nvs.write("str", "benchmark");
+    nvs.commit();
+
+    printf("\nMyNVS 基准测试：%s，%d次/项\n", PROFILE, ITERATIONS);
+    uint32_t u32 = 0;
+    int64_t i64 = 0;
+    std::string str;
+    measure("read u32", [&] { nvs.read("u32", u32); });
+    measure("read i64", [&] { nvs.read("i64", i64); });
+    measure("read_all x2", [&] { nvs.read_all(std::tie(u32, i64), "u32", "i64"); });
+    measure("read string", [&] { nvs.read("str", str); });
+    measure("read not found", [&] { nvs.read("missing", u32); });
+    measure("write u32 (same)", [&] { nvs.write("u32", 0x12345678u); });
+    // 以下为记录日志的失败路径
+    // 键名经volatile指针传入，避免编译器（如启用LTO时）对常量空键名的检查做折叠而省掉整个调用
+    static const char* volatile empty_key = "";
+    measure("read empty key", [&] { nvs.read(empty_key, u32); });
+    measure("write read-only", [&] { ro.write("u32", 1u); });
+    measure("read long key", [&] { nvs.read("key_name_longer_than_15", u32); });
+
+#if CONFIG_MYNVS_ERROR_RING
+    my_nvs_error_t records[4];
+    uint32_t dropped = 0;
+    size_t count = MyNVS_ErrorRing::read(records, 4, &dropped);
+    printf("错误环形缓冲区: 最近%u条，覆盖%u条\n", static_cast<unsigned>(count), static_cast<unsigned>(dropped));
+    for (size_t i = 0; i < count; i++) {
+        printf("  #%u %c %s:%u\n", static_cast<unsigned>(records[i].seq), records[i].level, records[i].tag, records[i].line);
+    }
+#endif
+    ESP_LOGI(TAG, "完成，可执行idf.py mynvs_size_report对比两种配置的代码体积");
+}
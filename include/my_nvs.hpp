@@ -16,10 +16,20 @@
 #ifndef MY_NVS_HPP_
 #define MY_NVS_HPP_
 
+#include <array>
+#include <chrono>
+#include <optional>
 #include <string>
+#include <tuple>
+#include <utility>
+#include <vector>
 #include <cstring>
 #include <mutex>
 #include <cstdint>
+#include <memory>
+#include <functional>
+#include <memory_resource>
+#include <bit>
 #include <concepts>
 #include <type_traits>
 #include "esp_log.h"
@@ -47,11 +57,153 @@ concept FloatingType = std::is_floating_point_v<T>;
 template<typename T>
 concept SupportedType = BoolType<T> || EnumType<T> || CharType<T> || IntegerType<T> || FloatingType<T>;
 
+// 扩展类型识别
+template<typename T> struct is_std_array : std::false_type {};
+template<typename E, size_t N> struct is_std_array<std::array<E, N>> : std::true_type {};
+template<typename T> struct is_std_vector : std::false_type {};
+template<typename E, typename A> struct is_std_vector<std::vector<E, A>> : std::true_type {};
+template<typename T> struct is_std_optional : std::false_type {};
+template<typename E> struct is_std_optional<std::optional<E>> : std::true_type {};
+template<typename T> struct is_chrono_duration : std::false_type {};
+template<typename R, typename P> struct is_chrono_duration<std::chrono::duration<R, P>> : std::true_type {};
+template<typename T> struct is_chrono_time_point : std::false_type {};
+template<typename C, typename D> struct is_chrono_time_point<std::chrono::time_point<C, D>> : std::true_type {};
+
+// 扩展类型概念：元素/计数类型须为原生支持类型
+template<typename T>
+concept ArrayType = is_std_array<T>::value && SupportedType<typename T::value_type>;
+template<typename T>
+concept VectorType = is_std_vector<T>::value && SupportedType<typename T::value_type> && !BoolType<typename T::value_type>;
+template<typename T>
+concept DurationType = is_chrono_duration<T>::value && SupportedType<typename T::rep>;
+template<typename T>
+concept TimePointType = is_chrono_time_point<T>::value && SupportedType<typename T::rep>;
+template<typename T>
+concept OptionalType = is_std_optional<T>::value
+    && (SupportedType<typename T::value_type> || ArrayType<typename T::value_type> || VectorType<typename T::value_type>
+        || DurationType<typename T::value_type> || TimePointType<typename T::value_type>);
+template<typename T>
+concept StorableType = SupportedType<T> || ArrayType<T> || VectorType<T> || DurationType<T> || TimePointType<T> || OptionalType<T>;
+
 // 辅助模板：用于 static_assert 报错
 template<class> inline constexpr bool always_false = false;
 
+// 类型到NVS存储类型的映射：bool/enum/char -> u8，整数按宽度与符号，浮点按位宽存为u32/u64
+template <SupportedType T>
+constexpr auto nvs_storage_of()
+{
+    if constexpr(BoolType<T> || EnumType<T> || CharType<T>) {
+        return uint8_t{};
+    } else if constexpr(IntegerType<T>) {
+        static_assert(sizeof(T) == 1 || sizeof(T) == 2 ||sizeof(T) == 4 ||sizeof(T) == 8, "不支持的整数大小，当前仅支持1/2/4/8字节整数");
+        if constexpr(sizeof(T) == 1) {
+            return std::conditional_t<std::is_signed_v<T>, int8_t, uint8_t>{};
+        } else if constexpr(sizeof(T) == 2) {
+            return std::conditional_t<std::is_signed_v<T>, int16_t, uint16_t>{};
+        } else if constexpr(sizeof(T) == 4) {
+            return std::conditional_t<std::is_signed_v<T>, int32_t, uint32_t>{};
+        } else {
+            return std::conditional_t<std::is_signed_v<T>, int64_t, uint64_t>{};
+        }
+    } else if constexpr(FloatingType<T>) {
+        using StorageType = std::conditional_t<sizeof(T) <= 4, uint32_t, uint64_t>;
+        static_assert(sizeof(T) == sizeof(StorageType), "浮点类型大小不匹配");
+        return StorageType{};
+    } else {
+        static_assert(always_false<T>, "暂不支持该类型");
+    }
+}
+template <SupportedType T>
+using nvs_storage_t = decltype(nvs_storage_of<T>());
+
+// 存储类型对应的NVS类型标识
+template <typename S>
+constexpr nvs_type_t nvs_type_of()
+{
+    if constexpr(std::is_same_v<S, uint8_t>)        return NVS_TYPE_U8;
+    else if constexpr(std::is_same_v<S, int8_t>)    return NVS_TYPE_I8;
+    else if constexpr(std::is_same_v<S, uint16_t>)  return NVS_TYPE_U16;
+    else if constexpr(std::is_same_v<S, int16_t>)   return NVS_TYPE_I16;
+    else if constexpr(std::is_same_v<S, uint32_t>)  return NVS_TYPE_U32;
+    else if constexpr(std::is_same_v<S, int32_t>)   return NVS_TYPE_I32;
+    else if constexpr(std::is_same_v<S, uint64_t>)  return NVS_TYPE_U64;
+    else if constexpr(std::is_same_v<S, int64_t>)   return NVS_TYPE_I64;
+    else static_assert(always_false<S>, "非NVS原生存储类型");
+}
+
+// NVS整数类型的字节宽度，非整数类型返回0
+constexpr size_t nvs_integer_size(nvs_type_t type)
+{
+    switch (type) {
+        case NVS_TYPE_U8:
+        case NVS_TYPE_I8:   return 1;
+        case NVS_TYPE_U16:
+        case NVS_TYPE_I16:  return 2;
+        case NVS_TYPE_U32:
+        case NVS_TYPE_I32:  return 4;
+        case NVS_TYPE_U64:
+        case NVS_TYPE_I64:  return 8;
+        default:            return 0;
+    }
+}
+constexpr bool nvs_integer_signed(nvs_type_t type)
+{
+    return type == NVS_TYPE_I8 || type == NVS_TYPE_I16 || type == NVS_TYPE_I32 || type == NVS_TYPE_I64;
+}
+
+// 组件内部实现，不属于公开接口
+namespace mynvs_detail {
+// 每种存储类型一份的原生读写函数（不加锁、不记日志），定义及显式实例化位于my_nvs.cpp
+template <typename S>
+esp_err_t get(nvs_handle_t handle, const char* key, void* out);
+template <typename S>
+esp_err_t set(nvs_handle_t handle, const char* key, uint64_t bits);
+
+// 存储类型对应的类型标识与读写函数，编译期确定
+struct scalar_ops_t {
+    nvs_type_t type;
+    esp_err_t (*get)(nvs_handle_t handle, const char* key, void* out);
+    esp_err_t (*set)(nvs_handle_t handle, const char* key, uint64_t bits);
+};
+template <typename S>
+inline constexpr scalar_ops_t scalar_ops = { nvs_type_of<S>(), &get<S>, &set<S> };
+
+// 类型仅在运行期可知时（遍历、镜像、迁移）的整数读取，非整数类型返回ESP_ERR_NOT_SUPPORTED
+esp_err_t get_integer(nvs_handle_t handle, const char* key, nvs_type_t type, void* out);
+}
+
+// 值与存储类型之间的转换
+template <SupportedType T>
+constexpr nvs_storage_t<T> nvs_to_storage(const T& value)
+{
+    if constexpr(BoolType<T>) {
+        return value ? 1 : 0;
+    } else if constexpr(FloatingType<T>) {
+        return std::bit_cast<nvs_storage_t<T>>(value);
+    } else {
+        return static_cast<nvs_storage_t<T>>(value);
+    }
+}
+template <SupportedType T>
+constexpr T nvs_from_storage(nvs_storage_t<T> tmp)
+{
+    if constexpr(BoolType<T>) {
+        return tmp != 0;
+    } else if constexpr(FloatingType<T>) {
+        return std::bit_cast<T>(tmp);
+    } else {
+        return static_cast<T>(tmp);
+    }
+}
+
 struct my_nvs_t;
 class MyNVS_Manager;
+class MyNVS_Snapshot;
+class MyNVS_Planner;
+class MyNVS_Migration;
+struct my_nvs_capacity_t;
+class MyNVS_Arena;
+struct my_nvs_arena_value_t;
 class MyNVS {
 public:
     explicit MyNVS(const char* name_space, nvs_open_mode_t mode = NVS_READONLY);
@@ -63,6 +215,11 @@ public:
         : MyNVS(partition, name_space, rw ? NVS_READWRITE : NVS_READONLY)
     {}
     ~MyNVS();
+
+    // 是否已成功打开（槽位已满、分区不存在等情况下打开失败）
+    inline bool opened() const {
+        return m_nvs != nullptr;
+    }
     
 
     // 字符串数据读取
@@ -75,6 +232,8 @@ public:
     {
         return read(key.c_str(), value);
     }
+    // value须以arena为分配器，在分配前按读取到的长度检查剩余容量，不足时返回ESP_ERR_NO_MEM且value不变
+    esp_err_t read(const char* key, std::pmr::string& value, MyNVS_Arena& arena);
     // 二进制数据读取
     esp_err_t read(const char* key, void* value, size_t* length);
     esp_err_t read(const std::string& key, void* value, size_t* length)
@@ -96,6 +255,10 @@ public:
     {
         return write(key.c_str(), value.c_str());
     }
+    esp_err_t write(const char* key, const std::pmr::string& value)
+    {
+        return write(key, value.c_str());
+    }
     esp_err_t write(const char* key, const void* value, size_t length);
     esp_err_t write(const std::string& key, const void* value, size_t length)
     {
@@ -111,32 +274,116 @@ public:
     esp_err_t erase_key(const std::string& key);
     esp_err_t erase_all();
     esp_err_t commit();
+    // 遍历名字空间内的全部键（可按类型过滤），回调在槽位锁之外调用，可在回调中读写
+    esp_err_t for_each(const std::function<void(const nvs_entry_info_t& info)>& visitor, nvs_type_t type = NVS_TYPE_ANY);
+
+    // 空间预检：plan所需条目数加跨页碎片预留不超过分区可用条目数时返回ESP_OK，
+    // 否则返回ESP_ERR_NVS_NOT_ENOUGH_SPACE，不访问待写入的键；report可为空
+    // replace_namespace为true时按先清空本名字空间再写入计算，本名字空间现有条目计入可用条目
+    esp_err_t can_fit(const MyNVS_Planner& plan, my_nvs_capacity_t* report = nullptr, bool replace_namespace = false);
+    // 分区及本名字空间的容量统计
+    esp_err_t capacity(my_nvs_capacity_t* report);
+
+    // 批量加载：将键名以prefix开头（为空时全部）的字符串/Blob连同键名一次性放入arena，out的元素数组也只分配一次
+    // 先统计所需空间，arena剩余空间不足时返回ESP_ERR_NO_MEM且不做任何分配；整批只加锁一次
+    esp_err_t load_strings(const char* prefix, MyNVS_Arena& arena, std::pmr::vector<my_nvs_arena_value_t>& out);
+    esp_err_t load_blobs(const char* prefix, MyNVS_Arena& arena, std::pmr::vector<my_nvs_arena_value_t>& out);
+
+    // 结构迁移：按版本执行迁移步骤，每个版本加锁一次、提交一次，已是最新版本时只需一次读取
+    esp_err_t migrate(const MyNVS_Migration& migration);
+
+    // 镜像导出/导入：通过名字空间迭代器将全部键值序列化为带CRC的版本化镜像（格式见my_nvs_image.hpp）
+    // 导入时先完成校验及空间预检，再加锁一次写入全部条目并提交一次
+    // erase_first为true时先清空名字空间，预检按清空后的空间计算，预检失败时不擦除
+    // 写入中途失败时恢复导入前的内容；成功后通知ERASE_ALL（erase_first时）及导入的各个键
+    esp_err_t export_namespace(std::vector<uint8_t>& image);
+    esp_err_t import_namespace(const void* image, size_t length, bool erase_first = false);
+    esp_err_t import_namespace(const std::vector<uint8_t>& image, bool erase_first = false) {
+        return import_namespace(image.data(), image.size(), erase_first);
+    }
+
+    // 快照模式：将名字空间加载为不可变快照，此后每次commit成功后发布新快照
+    // 快照上的读取不加槽位锁、不访问Flash；旧快照在最后一个持有者释放后自动回收
+    // snapshot()内部为atomic<shared_ptr>加载（实现内含锁并修改引用计数），不宜在热路径上每次调用，
+    // 读者应缓存返回的shared_ptr，或使用MyNVS_SnapshotReader仅在snapshot_version()变化时重新获取
+    esp_err_t enable_snapshot();
+    esp_err_t disable_snapshot();
+    std::shared_ptr<const MyNVS_Snapshot> snapshot() const;
+    uint32_t snapshot_version() const;
+
+    // 变更订阅：监听本名字空间内以prefix开头的键（prefix为空时监听全部键）
+    int watch(const char* prefix, my_nvs_watch_cb_t callback);
+    int watch(const char* prefix, QueueHandle_t queue);
+    void unwatch(int id);
+    // 批量操作：begin_batch/end_batch之间的变更通知被合并，end_batch时每个键只通知一次，可嵌套
+    // 批量状态属于本实例，多个任务共用一个实例时，任一任务的批量期间其他任务的通知同样被合并
+    void begin_batch();
+    void end_batch();
 
     // 读取函数模板（引用版本）
-    template <SupportedType T>
+    template <StorableType T>
     esp_err_t read(const char* key, T& value);
 
     // 读取重载
-    template <SupportedType T>
+    template <StorableType T>
     esp_err_t read(const char* key, T* value);
-    template <SupportedType T>
+    template <StorableType T>
     esp_err_t read(const std::string& key, T* value);
-    template <SupportedType T>
+    template <StorableType T>
     esp_err_t read(const std::string& key, T& value);
 
     // 写入函数模板
-    template <SupportedType T>
+    template <StorableType T>
     esp_err_t write(const char* key, const T& value);
-    template <SupportedType T>
+    template <StorableType T>
     esp_err_t write(const std::string& key, const T& value);
+
+    // 批量读写：整批只加锁一次，返回每个键的错误码，类型映射在编译期完成
+    // nvs.read_all(std::tie(a, b, c), "ka", "kb", "kc");
+    // nvs.write_all(std::tie(a, b, c), "ka", "kb", "kc");
+    template <SupportedType... Ts, typename... Keys>
+        requires (sizeof...(Ts) == sizeof...(Keys)) && (std::convertible_to<Keys, const char*> && ...)
+    std::array<esp_err_t, sizeof...(Ts)> read_all(std::tuple<Ts&...> values, Keys... keys);
+    template <typename... Ts, typename... Keys>
+        requires (sizeof...(Ts) == sizeof...(Keys)) && (SupportedType<std::remove_cvref_t<Ts>> && ...)
+            && (std::convertible_to<Keys, const char*> && ...)
+    std::array<esp_err_t, sizeof...(Ts)> write_all(const std::tuple<Ts...>& values, Keys... keys);
       
 
 private:
     inline bool is_valid() const {
         return m_nvs && m_nvs->handle != 0;
     }
+    // 共享的键名校验与加锁路径，key超长时截断至safe_key
+    esp_err_t check_key(const char*& key, char* safe_key);
+    esp_err_t lock_key(const char*& key, char* safe_key, std::unique_lock<std::mutex>& lock, bool write);
+    esp_err_t lock_slot(std::unique_lock<std::mutex>& lock, bool write);
+    // 原生类型读写核心（非内联）：读写函数由ops按存储类型在编译期选定，校验与加锁路径共用
+    esp_err_t read_item(const char* key, const mynvs_detail::scalar_ops_t& ops, void* out);
+    esp_err_t write_item(const char* key, const mynvs_detail::scalar_ops_t& ops, uint64_t bits);
+    // 批量读写核心：整批只加锁一次，errs返回每个键的结果；返回值为加锁结果
+    // ops为编译期按元素类型生成的读写函数表，循环中不再按类型分发
+    esp_err_t read_items(const char* const* keys, const mynvs_detail::scalar_ops_t* const* ops, void* const* outs, esp_err_t* errs, size_t count);
+    esp_err_t write_items(const char* const* keys, const mynvs_detail::scalar_ops_t* const* ops, const uint64_t* bits, esp_err_t* errs, size_t count);
+    // 变长Blob读取核心：查询长度后由alloc分配目标内存（返回nullptr表示长度不匹配），仅加锁一次
+    using blob_alloc_t = void* (*)(void* ctx, size_t length);
+    esp_err_t read_blob(const char* key, blob_alloc_t alloc, void* ctx);
+    // 字符串读取核心：alloc的长度含结尾'\0'
+    esp_err_t read_str(const char* key, blob_alloc_t alloc, void* ctx);
+    esp_err_t load_values(const char* prefix, nvs_type_t type, MyNVS_Arena& arena, std::pmr::vector<my_nvs_arena_value_t>& out);
+    // 按原始字节写入任意类型的值（整数为小端原始宽度，字符串含结尾'\0'），调用方须持有槽位锁
+    // check_value只做编码校验，供调用方在首次写入前校验整批数据
+    static esp_err_t check_value(nvs_type_t type, const void* data, size_t length);
+    static esp_err_t set_value(nvs_handle_t handle, const char* key, nvs_type_t type, const void* data, size_t length);
+    // 变更通知：须在释放槽位锁后调用，批量模式下仅记录
+    void notify(my_nvs_event_type_t type, const char* key);
+    void notify_events(std::vector<my_nvs_event_t>& events);
+
     my_nvs_t*       m_nvs;
     MyNVS_Manager*  m_manager;
+    std::mutex      m_batch_mutex;          // 保护m_batch_depth及m_pending，实例可在多个任务间共用
+    int             m_batch_depth = 0;
+    std::vector<my_nvs_event_t> m_pending;  // 批量模式下待发送的合并事件
 };
 
 
@@ -145,128 +392,63 @@ private:
 // 模板函数实现
 // ======================================================
 
-// 模板读取实现
-template <SupportedType T>
+// 模板读取实现：仅做类型转换，校验、加锁、日志均在非内联核心中完成
+template <StorableType T>
 esp_err_t MyNVS::read(const char* key, T& value)
 {
-    if (key == nullptr || *key == '\0') {
-        ESP_LOGE("MyNVS-HPP", "键名为空");
-        return ESP_ERR_INVALID_ARG;
-    }
-
-    char safe_key[KEY_LENGTH + 1];
-    if (strlen(key) > KEY_LENGTH) {
-        strncpy(safe_key, key, KEY_LENGTH);
-        safe_key[KEY_LENGTH] = '\0';
-        ESP_LOGW("MyNVS-HPP", "key length is too loog, original key=%s key=%s, may be cause error!", key, safe_key);
-        key = safe_key;
-    }
-    
-    if(!m_nvs) {
-        ESP_LOGE("MyNVS-HPP", "NVS未正确打开或实例已失效");
-        return ESP_FAIL;
-    }
-    std::unique_lock<std::mutex> lock(m_nvs->mutex, std::try_to_lock);
-    if(!lock.owns_lock() || m_nvs->handle == 0) {
-        ESP_LOGE("MyNVS-HPP", "尝试加锁失败或NVS已关闭");
-        return ESP_FAIL;
-    }
-    
-    if constexpr(BoolType<T>) {
-        uint8_t tmp = 0;
-        auto err = nvs_get_u8(m_nvs->handle, key, &tmp);
-        if(ESP_OK == err) {
-            value = (tmp != 0);
-            return ESP_OK;
+    if constexpr(SupportedType<T>) {
+        nvs_storage_t<T> tmp{};
+        auto err = read_item(key, mynvs_detail::scalar_ops<nvs_storage_t<T>>, &tmp);
+        if (ESP_OK == err) {
+            value = nvs_from_storage<T>(tmp);
         }
         return err;
-    } else if constexpr(EnumType<T>) {
-        uint8_t tmp = value ? (uint8_t)1 : 0;
-        auto err = nvs_get_u8(m_nvs->handle, key, &tmp);
-        if (err == ESP_OK) {
-            value = static_cast<T>(tmp);
+    } else if constexpr(DurationType<T>) {
+        typename T::rep count{};
+        auto err = read(key, count);
+        if (ESP_OK == err) {
+            value = T(count);
         }
         return err;
-    } else if constexpr(CharType<T>) {
-        uint8_t tmp = 0;
-        auto err = nvs_get_u8(m_nvs->handle, key, &tmp);
-        if(ESP_OK == err) {
-            value = static_cast<char>(tmp);
+    } else if constexpr(TimePointType<T>) {
+        typename T::rep count{};
+        auto err = read(key, count);
+        if (ESP_OK == err) {
+            value = T(typename T::duration(count));
         }
         return err;
-    } else if constexpr(IntegerType<T>) {
-        static_assert(sizeof(T) == 1 || sizeof(T) == 2 ||sizeof(T) == 4 ||sizeof(T) == 8, "不支持的整数大小，当前仅支持1/2/4/8字节整数");
-        esp_err_t err = ESP_ERR_NOT_SUPPORTED;
-        if constexpr(sizeof(T) == 1) {
-            if constexpr(std::is_signed_v<T>) {
-                int8_t tmp = 0;
-                err = nvs_get_i8(m_nvs->handle, key, &tmp);
-                if(ESP_OK == err) {
-                    value = tmp;
-                }
-            } else {
-                uint8_t tmp = 0;
-                err = nvs_get_u8(m_nvs->handle, key, &tmp);
-                if(ESP_OK == err) {
-                    value = tmp;
-                }
-            }
-        } else if constexpr(sizeof(T) == 2) {
-            if constexpr(std::is_signed_v<T>) {
-                int16_t tmp = 0;
-                err = nvs_get_i16(m_nvs->handle, key, &tmp);
-                if(ESP_OK == err) {
-                    value = tmp;
-                }
-            } else {
-                uint16_t tmp;
-                err = nvs_get_u16(m_nvs->handle, key, &tmp);
-                if(ESP_OK == err) {
-                    value = tmp;
-                }
+    } else if constexpr(ArrayType<T>) {
+        constexpr size_t size = sizeof(typename T::value_type) * std::tuple_size_v<T>;
+        if constexpr(size <= sizeof(uint64_t)) {
+            // 小数组打包在一个u64中
+            uint64_t bits = 0;
+            auto err = read_item(key, mynvs_detail::scalar_ops<uint64_t>, &bits);
+            if (ESP_OK == err) {
+                std::memcpy(value.data(), &bits, size);
             }
-        } else if constexpr(sizeof(T) == 4) {
-            if constexpr(std::is_signed_v<T>) {
-                int32_t tmp = 0;
-                err = nvs_get_i32(m_nvs->handle, key, &tmp);
-                if(ESP_OK == err) {
-                    value = tmp;
-                }
-            } else {
-                uint32_t tmp = 0;
-                err = nvs_get_u32(m_nvs->handle, key, &tmp);
-                if(ESP_OK == err) {
-                    value = tmp;
-                }
-            }
-        } else if constexpr(sizeof(T) == 8) {
-            if constexpr(std::is_signed_v<T>) {
-                int64_t tmp = 0;
-                err = nvs_get_i64(m_nvs->handle, key, &tmp);
-                if(ESP_OK == err) {
-                    value = tmp;
-                }
-            } else {
-                uint64_t tmp = 0;
-                err = nvs_get_u64(m_nvs->handle, key, &tmp);
-                if(ESP_OK == err) {
-                    value = tmp;
-                }
-            }
-        }
-        return err;
-    } else if constexpr(FloatingType<T>) {
-        using StorageType = std::conditional_t<sizeof(T) <= 4, uint32_t, uint64_t>;
-        static_assert(sizeof(T) == sizeof(StorageType), "浮点类型大小不匹配");
-        StorageType tmp = 0;
-        esp_err_t err = ESP_OK;
-        if constexpr(sizeof(T) <= 4) {
-            err = nvs_get_u32(m_nvs->handle, key, &tmp);
+            return err;
         } else {
-            err = nvs_get_u64(m_nvs->handle, key, &tmp);
+            return read_blob(key, [](void* ctx, size_t length) -> void* {
+                return length == size ? static_cast<T*>(ctx)->data() : nullptr;
+            }, &value);
         }
-        if(ESP_OK == err) {
-            std::memcpy(&value, &tmp, sizeof(T));
+    } else if constexpr(VectorType<T>) {
+        return read_blob(key, [](void* ctx, size_t length) -> void* {
+            auto& vec = *static_cast<T*>(ctx);
+            if (length % sizeof(typename T::value_type) != 0) {
+                return nullptr;
+            }
+            vec.resize(length / sizeof(typename T::value_type));
+            return vec.empty() ? ctx : static_cast<void*>(vec.data());
+        }, &value);
+    } else if constexpr(OptionalType<T>) {
+        // 键不存在时置为空值
+        typename T::value_type tmp{};
+        auto err = read(key, tmp);
+        if (ESP_OK == err) {
+            value = std::move(tmp);
+        } else if (ESP_ERR_NVS_NOT_FOUND == err) {
+            value.reset();
             return ESP_OK;
         }
         return err;
@@ -275,102 +457,106 @@ esp_err_t MyNVS::read(const char* key, T& value)
         return ESP_ERR_NOT_SUPPORTED;
     }
 }
-// 模板写入实现
-template <SupportedType T>
+// 模板写入实现：仅做类型转换，校验、加锁、日志均在非内联核心中完成
+template <StorableType T>
 esp_err_t MyNVS::write(const char* key, const T& value)
 {
-    if (key == nullptr || *key == '\0') {
-        ESP_LOGE("MyNVS-HPP", "键名为空");
-        return ESP_ERR_INVALID_ARG;
-    }
-    char safe_key[KEY_LENGTH + 1];
-    if (strlen(key) > KEY_LENGTH) {
-        strncpy(safe_key, key, KEY_LENGTH);
-        safe_key[KEY_LENGTH] = '\0';
-        ESP_LOGW("MyNVS-HPP", "key length is too loog, original key=%s key=%s, may be cause error!", key, safe_key);
-        key = safe_key;
-    }
-
-    if(!m_nvs || m_nvs->open_mode != NVS_READWRITE) {
-        ESP_LOGE("MyNVS-HPP", "NVS只读或实例已失效");
-        return ESP_FAIL;
-    }
-    std::unique_lock<std::mutex> lock(m_nvs->mutex, std::try_to_lock);
-    if(!lock.owns_lock() || !is_valid()) {
-        ESP_LOGE("MyNVS-HPP", "NVS未正确打开或实例已失效");
-        return ESP_FAIL;
-    }
-    if constexpr(BoolType<T>) {
-        return nvs_set_u8(m_nvs->handle, key, value ? 1 : 0);
-    } else if constexpr(EnumType<T>) {
-        return nvs_set_u8(m_nvs->handle, key, static_cast<uint8_t>(value));
-    } else if constexpr(CharType<T>) {
-        return nvs_set_u8(m_nvs->handle, key, static_cast<uint8_t>(value));
-    } else if constexpr(IntegerType<T>) {
-        static_assert(sizeof(T) == 1 || sizeof(T) == 2 ||sizeof(T) == 4 ||sizeof(T) == 8, "不支持的整数大小，当前仅支持1/2/4/8字节整数");
-        esp_err_t err = ESP_ERR_NOT_SUPPORTED;
-        if constexpr(sizeof(T) == 1) {
-            if constexpr(std::is_signed_v<T>) {
-                return nvs_set_i8(m_nvs->handle, key, value);
-            } else {
-                return nvs_set_u8(m_nvs->handle, key, value);
-            }
-        } else if constexpr(sizeof(T) == 2) {
-            if constexpr(std::is_signed_v<T>) {
-                return nvs_set_i16(m_nvs->handle, key, value);
-            } else {
-                return nvs_set_u16(m_nvs->handle, key, value);
-            }
-        } else if constexpr(sizeof(T) == 4) {
-            if constexpr(std::is_signed_v<T>) {
-                return nvs_set_i32(m_nvs->handle, key, value);
-            } else {
-                return nvs_set_u32(m_nvs->handle, key, value);
-            }
-        } else if constexpr(sizeof(T) == 8) {
-            if constexpr(std::is_signed_v<T>) {
-                return nvs_set_i64(m_nvs->handle, key, value);
-            } else {
-                return nvs_set_u64(m_nvs->handle, key, value);
-            }
-        }
-        ESP_LOGE("MyNVS-HPP", "写入%s失败: %s", key, esp_err_to_name(err));
-        return err;
-    } else if constexpr(FloatingType<T>) {
-        using StorageType = std::conditional_t<sizeof(T) <= 4, uint32_t, uint64_t>;
-        static_assert(sizeof(T) == sizeof(StorageType), "浮点类型大小不匹配");
-        StorageType tmp;
-        std::memcpy(&tmp, &value, sizeof(T));
-        if constexpr(sizeof(T) <= 4) {
-            return nvs_set_u32(m_nvs->handle, key, tmp);
+    if constexpr(SupportedType<T>) {
+        using StorageType = nvs_storage_t<T>;
+        // 有符号数先符号扩展至64位，由核心按存储类型截断
+        using WideType = std::conditional_t<std::is_signed_v<StorageType>, int64_t, uint64_t>;
+        return write_item(key, mynvs_detail::scalar_ops<StorageType>, static_cast<uint64_t>(static_cast<WideType>(nvs_to_storage(value))));
+    } else if constexpr(DurationType<T>) {
+        return write(key, value.count());
+    } else if constexpr(TimePointType<T>) {
+        return write(key, value.time_since_epoch().count());
+    } else if constexpr(ArrayType<T>) {
+        constexpr size_t size = sizeof(typename T::value_type) * std::tuple_size_v<T>;
+        if constexpr(size <= sizeof(uint64_t)) {
+            uint64_t bits = 0;
+            std::memcpy(&bits, value.data(), size);
+            return write_item(key, mynvs_detail::scalar_ops<uint64_t>, bits);
         } else {
-            return nvs_set_u64(m_nvs->handle, key, tmp);
+            return write(key, static_cast<const void*>(value.data()), size);
         }
+    } else if constexpr(VectorType<T>) {
+        // 直接以容器内存作为Blob写入，空容器写入零长度Blob
+        const void* data = value.empty() ? static_cast<const void*>(&value) : static_cast<const void*>(value.data());
+        return write(key, data, value.size() * sizeof(typename T::value_type));
+    } else if constexpr(OptionalType<T>) {
+        // 空值对应删除该键
+        if (value.has_value()) {
+            return write(key, *value);
+        }
+        auto err = erase_key(key);
+        return err == ESP_ERR_NVS_NOT_FOUND ? ESP_OK : err;
     } else {
         static_assert(always_false<T>, "暂不支持该类型");
         return ESP_ERR_NOT_SUPPORTED;
     }
 }
 
+// 批量读取实现
+template <SupportedType... Ts, typename... Keys>
+    requires (sizeof...(Ts) == sizeof...(Keys)) && (std::convertible_to<Keys, const char*> && ...)
+std::array<esp_err_t, sizeof...(Ts)> MyNVS::read_all(std::tuple<Ts&...> values, Keys... keys)
+{
+    constexpr size_t count = sizeof...(Ts);
+    std::array<esp_err_t, count> errs{};
+    if constexpr(count > 0) {
+        std::tuple<nvs_storage_t<Ts>...> tmp{};
+        const char* key_list[count] = { static_cast<const char*>(keys)... };
+        static constexpr const mynvs_detail::scalar_ops_t* ops[count] = { &mynvs_detail::scalar_ops<nvs_storage_t<Ts>>... };
+        [&]<size_t... I>(std::index_sequence<I...>) {
+            void* outs[count] = { &std::get<I>(tmp)... };
+            read_items(key_list, ops, outs, errs.data(), count);
+            ((errs[I] == ESP_OK ? (void)(std::get<I>(values) = nvs_from_storage<Ts>(std::get<I>(tmp))) : (void)0), ...);
+        }(std::index_sequence_for<Ts...>{});
+    }
+    return errs;
+}
+
+// 批量写入实现
+template <typename... Ts, typename... Keys>
+    requires (sizeof...(Ts) == sizeof...(Keys)) && (SupportedType<std::remove_cvref_t<Ts>> && ...)
+        && (std::convertible_to<Keys, const char*> && ...)
+std::array<esp_err_t, sizeof...(Ts)> MyNVS::write_all(const std::tuple<Ts...>& values, Keys... keys)
+{
+    constexpr size_t count = sizeof...(Ts);
+    std::array<esp_err_t, count> errs{};
+    if constexpr(count > 0) {
+        const char* key_list[count] = { static_cast<const char*>(keys)... };
+        static constexpr const mynvs_detail::scalar_ops_t* ops[count] = { &mynvs_detail::scalar_ops<nvs_storage_t<std::remove_cvref_t<Ts>>>... };
+        [&]<size_t... I>(std::index_sequence<I...>) {
+            const uint64_t bits[count] = {
+                static_cast<uint64_t>(static_cast<std::conditional_t<std::is_signed_v<nvs_storage_t<std::remove_cvref_t<Ts>>>, int64_t, uint64_t>>(
+                    nvs_to_storage(std::get<I>(values))))...
+            };
+            write_items(key_list, ops, bits, errs.data(), count);
+        }(std::index_sequence_for<Ts...>{});
+    }
+    return errs;
+}
+
 // 读取重载
-template <SupportedType T>
+template <StorableType T>
 esp_err_t MyNVS::read(const char* key, T* value)
 {
     return read(key, *value);
 }
-template <SupportedType T>
+template <StorableType T>
 esp_err_t MyNVS::read(const std::string& key, T* value)
 {
     return read(key.c_str(), *value);
 }
-template <SupportedType T>
+template <StorableType T>
 esp_err_t MyNVS::read(const std::string& key, T& value)
 {
     return read(key.c_str(), value);
 }
 
 // 写入重载
-template <SupportedType T>
+template <StorableType T>
 esp_err_t MyNVS::write(const std::string& key, const T& value) 
 {
     return write(key.c_str(), value);
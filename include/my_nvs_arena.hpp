@@ -0,0 +1,80 @@
+/*
+ *             Copyright [2025] [samllin]
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *        http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <memory_resource>
+#include <string_view>
+
+// 批量加载的一个键值，key与data均位于arena中，生命周期到arena.release()或析构为止
+struct my_nvs_arena_value_t {
+    const char* key;        // 以'\0'结尾
+    const char* data;       // 字符串或Blob原始字节，其后总有一个'\0'
+    size_t      length;     // 不含结尾'\0'
+
+    std::string_view view() const {
+        return {data, length};
+    }
+};
+
+// 单调内存池：在一块连续内存上顺序分配，deallocate不回收，release()一次释放全部
+// 可作为std::pmr容器的内存资源，避免启动阶段大量小块分配造成的堆碎片；非线程安全
+// 容量不足时按std::pmr约定抛出std::bad_alloc（未启用C++异常时直接abort），MyNVS::load_*及read(key, value, arena)会预先检查容量
+class MyNVS_Arena : public std::pmr::memory_resource {
+public:
+    // 使用外部缓冲区（静态数组、PSRAM等），不访问堆
+    MyNVS_Arena(void* buffer, size_t size);
+    // 从upstream一次性申请size字节，析构时一次性归还
+    explicit MyNVS_Arena(size_t size, std::pmr::memory_resource* upstream = std::pmr::get_default_resource());
+    ~MyNVS_Arena();
+    MyNVS_Arena(const MyNVS_Arena&) = delete;
+    MyNVS_Arena& operator=(const MyNVS_Arena&) = delete;
+
+    // 释放全部分配（之前取得的指针全部失效），高水位保留
+    void release() {
+        m_used = 0;
+    }
+    size_t capacity() const {
+        return m_size;
+    }
+    size_t used() const {
+        return m_used;
+    }
+    size_t remaining() const {
+        return m_size - m_used;
+    }
+    // 自构造以来的最大用量，用于确定缓冲区大小
+    size_t high_water() const {
+        return m_high_water;
+    }
+    // 按alignment对齐后分配bytes字节所需的空间（含对齐填充）
+    size_t required(size_t bytes, size_t alignment) const;
+
+private:
+    void* do_allocate(size_t bytes, size_t alignment) override;
+    void do_deallocate(void*, size_t, size_t) override {}
+    bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override {
+        return this == &other;
+    }
+
+    uint8_t*                    m_buffer;
+    size_t                      m_size;
+    size_t                      m_used = 0;
+    size_t                      m_high_water = 0;
+    std::pmr::memory_resource*  m_upstream;     // 为空时缓冲区由外部提供
+};
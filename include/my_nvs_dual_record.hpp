@@ -0,0 +1,87 @@
+/*
+ *             Copyright [2025] [samllin]
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *        http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+
+#pragma once
+
+#include <type_traits>
+#include "my_nvs.hpp"
+
+#define DUAL_RECORD_NAME_LENGTH     (KEY_LENGTH - 2)    // 记录名最大长度，预留".a/.b/.p"后缀
+
+// A/B双备份大记录：两份带CRC和代数的Blob（<name>.a、<name>.b）加一个指向当前有效副本的指针键（<name>.p）
+// 1. 写入总是写到非活动副本并提交，再更新指针并提交，写入过程中复位时旧副本仍然有效
+// 2. 读取只校验指针所指的活动副本，活动副本损坏时回退到另一副本；指针不存在或无效时比较两份副本的代数
+// 3. 启动时的校验开销为一次CRC
+// 4. 对象缓存了活动副本及代数，同一记录应只通过一个对象写入
+// 5. 读写使用对象内的头部+数据缓冲区，不做堆分配
+class MyNVS_DualRecordBase {
+public:
+    MyNVS_DualRecordBase(MyNVS& nvs, const char* name);
+
+    // 当前活动副本（0:A 1:B，-1:未知）及其代数
+    int active() const {
+        return m_active;
+    }
+    uint32_t generation() const {
+        return m_generation;
+    }
+
+protected:
+    struct header_t {
+        uint32_t    magic;
+        uint32_t    generation;
+        uint32_t    length;
+        uint32_t    crc;
+    };
+
+    // buffer为调用方提供的缓冲区，长度须为sizeof(header_t) + length
+    // 读取活动副本，两份副本均不存在时返回ESP_ERR_NVS_NOT_FOUND，均损坏时返回ESP_ERR_INVALID_CRC
+    esp_err_t load(void* value, size_t length, uint8_t* buffer);
+    // 写入非活动副本并切换指针
+    esp_err_t store(const void* value, size_t length, uint8_t* buffer);
+
+private:
+    // 读取并校验一份副本，校验通过后数据位于buffer + sizeof(header_t)
+    esp_err_t read_copy(int index, size_t length, uint8_t* buffer, uint32_t* generation);
+    esp_err_t select_copy(size_t length, uint8_t* buffer, int* index, uint32_t* generation);
+    static uint32_t crc_of(const header_t& header, const void* value, size_t length);
+
+    MyNVS&      m_nvs;
+    char        m_keys[2][KEY_LENGTH + 1];
+    char        m_pointer_key[KEY_LENGTH + 1];
+    int         m_active = -1;
+    uint32_t    m_generation = 0;
+};
+
+template <typename T>
+    requires std::is_trivially_copyable_v<T>
+class MyNVS_DualRecord : private MyNVS_DualRecordBase {
+public:
+    MyNVS_DualRecord(MyNVS& nvs, const char* name)
+        : MyNVS_DualRecordBase(nvs, name)
+    {}
+    esp_err_t load(T& value) {
+        return MyNVS_DualRecordBase::load(&value, sizeof(T), m_buffer);
+    }
+    esp_err_t store(const T& value) {
+        return MyNVS_DualRecordBase::store(&value, sizeof(T), m_buffer);
+    }
+    using MyNVS_DualRecordBase::active;
+    using MyNVS_DualRecordBase::generation;
+
+private:
+    alignas(header_t) uint8_t m_buffer[sizeof(header_t) + sizeof(T)];
+};
@@ -0,0 +1,38 @@
+/*
+ *             Copyright [2025] [samllin]
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *        http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+
+#pragma once
+
+#include <cstdint>
+
+// 名字空间镜像格式（小端），由MyNVS::export_namespace生成、MyNVS::import_namespace导入，
+// 也可由主机工具tools/mynvs_image.py离线生成
+//
+//  头部：magic(u32) version(u16) count(u16) payload_length(u32) crc32(u32)
+//        crc32依次覆盖头部前12字节（magic、version、count、payload_length）及全部条目
+//  条目：type(u8，nvs_type_t) key_length(u8) key(不含'\0') value_length(u32) value
+//        整数值为小端原始宽度，字符串值含结尾'\0'，Blob为原始字节
+#define MY_NVS_IMAGE_MAGIC      0x49564E4D  // "MNVI"
+#define MY_NVS_IMAGE_VERSION    2           // 版本1的CRC只覆盖条目
+
+struct my_nvs_image_header_t {
+    uint32_t    magic;
+    uint16_t    version;
+    uint16_t    count;
+    uint32_t    payload_length;
+    uint32_t    crc;
+};
+static_assert(sizeof(my_nvs_image_header_t) == 16, "镜像头部须为16字节");
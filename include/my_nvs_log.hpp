@@ -0,0 +1,58 @@
+/*
+ *             Copyright [2025] [samllin]
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *        http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include "sdkconfig.h"
+#include "esp_log.h"
+
+// 组件内部日志
+//  CONFIG_MYNVS_FAST_PATH：日志及其格式字符串、参数（如esp_err_to_name）全部编译去除
+//  CONFIG_MYNVS_ERROR_RING：额外将错误/警告日志位置(TAG+行号)记录到无锁环形缓冲区，可与FAST_PATH同时使用
+#if CONFIG_MYNVS_ERROR_RING
+struct my_nvs_error_t {
+    const char* tag;        // 产生错误的模块TAG
+    uint16_t    line;       // 源码行号
+    char        level;      // 'E'或'W'
+    uint32_t    seq;        // 全局序号，从1开始
+};
+
+// 多生产者无锁环形缓冲区，写满后覆盖最旧的记录
+class MyNVS_ErrorRing {
+public:
+    static void push(const char* tag, uint16_t line, char level);
+    // 按时间顺序读出当前保留的记录，返回条数；dropped返回被覆盖的记录数
+    static size_t read(my_nvs_error_t* out, size_t max, uint32_t* dropped = nullptr);
+    static void clear();
+};
+#define MYNVS_RECORD(tag, level)    MyNVS_ErrorRing::push(tag, __LINE__, level)
+#else
+#define MYNVS_RECORD(tag, level)    ((void)0)
+#endif
+
+#if CONFIG_MYNVS_FAST_PATH
+#define MYNVS_LOGE(tag, format, ...)    MYNVS_RECORD(tag, 'E')
+#define MYNVS_LOGW(tag, format, ...)    MYNVS_RECORD(tag, 'W')
+#define MYNVS_LOGI(tag, format, ...)    ((void)0)
+#define MYNVS_LOGD(tag, format, ...)    ((void)0)
+#else
+#define MYNVS_LOGE(tag, format, ...)    do { MYNVS_RECORD(tag, 'E'); ESP_LOGE(tag, format, ##__VA_ARGS__); } while (0)
+#define MYNVS_LOGW(tag, format, ...)    do { MYNVS_RECORD(tag, 'W'); ESP_LOGW(tag, format, ##__VA_ARGS__); } while (0)
+#define MYNVS_LOGI(tag, format, ...)    ESP_LOGI(tag, format, ##__VA_ARGS__)
+#define MYNVS_LOGD(tag, format, ...)    ESP_LOGD(tag, format, ##__VA_ARGS__)
+#endif
@@ -17,14 +17,40 @@
 #pragma once
 
 #include <string>
+#include <memory>
 #include <mutex>
 #include <atomic>
+#include <vector>
+#include <functional>
 #include <condition_variable>
+#include "freertos/FreeRTOS.h"
+#include "freertos/queue.h"
 #include "nvs_flash.h"
 #include "sdkconfig.h"
 
 #define INVALID_INDEX           -1  // 索引无效标识
+#define INVALID_WATCH_ID        -1  // 订阅ID无效标识
 
+// 键变更事件类型
+typedef enum {
+    MY_NVS_EVENT_WRITE,         // 写入键
+    MY_NVS_EVENT_ERASE,         // 删除键
+    MY_NVS_EVENT_ERASE_ALL,     // 清空名字空间
+    MY_NVS_EVENT_COMMIT,        // 提交
+} my_nvs_event_type_t;
+
+// 键变更事件（ERASE_ALL、COMMIT事件的key为空串）
+struct my_nvs_event_t {
+    my_nvs_event_type_t type;
+    char                partition[NVS_PART_NAME_MAX_SIZE];
+    char                name_space[NVS_NS_NAME_MAX_SIZE];
+    char                key[NVS_KEY_NAME_MAX_SIZE];
+};
+
+// 变更回调，在槽位锁之外调用，可在回调中继续读写NVS
+using my_nvs_watch_cb_t = std::function<void(const my_nvs_event_t& event)>;
+
+class MyNVS_Snapshot;
 struct my_nvs_t {
     std::string         partition;  // 分区名
     std::string         name_space; // 名字空间
@@ -32,6 +58,12 @@ struct my_nvs_t {
     nvs_handle_t        handle;     // 操作句柄
     std::mutex          mutex;      // 操作锁
     std::atomic<int>    ref;        // 引用计数
+    std::atomic<std::shared_ptr<const MyNVS_Snapshot>> snapshot;   // 快照模式下发布的只读快照
+    std::atomic<uint32_t> snapshot_version{0};  // 快照每次发布递增
+    bool                snapshot_enabled;   // 快照模式是否开启，受mutex保护
+#if CONFIG_MYNVS_WARM_CACHE
+    uint32_t            cache_id;   // 热缓存中的名字空间标识
+#endif
 };
 
 class MyNVS_Manager {
@@ -42,14 +74,41 @@ public:
     int8_t open(const char* name_space, nvs_open_mode_t mode = NVS_READONLY);
     int8_t open(const char* partition, const char* name_space, nvs_open_mode_t mode = NVS_READONLY);
     void close(my_nvs_t* my_nvs);
+
+    // 变更订阅：prefix为nullptr或空串时匹配名字空间内全部键，返回订阅ID
+    int watch(const char* partition, const char* name_space, const char* prefix, my_nvs_watch_cb_t callback);
+    // 变更订阅：事件以my_nvs_event_t拷贝非阻塞投递到队列，队列满时丢弃
+    int watch(const char* partition, const char* name_space, const char* prefix, QueueHandle_t queue);
+    void unwatch(int id);
+    // 分发变更事件，调用方不得持有槽位锁
+    void notify(const my_nvs_t* my_nvs, my_nvs_event_type_t type, const char* key);
+    void notify(const my_nvs_event_t& event);
+    static my_nvs_event_t make_event(const my_nvs_t* my_nvs, my_nvs_event_type_t type, const char* key);
+    inline bool has_watchers() const {
+        return m_watch_count.load(std::memory_order_relaxed) != 0;
+    }
 private:
+    struct watcher_t {
+        int                 id;
+        std::string         partition;
+        std::string         name_space;
+        std::string         prefix;
+        my_nvs_watch_cb_t   callback;
+        QueueHandle_t       queue;
+    };
+
     MyNVS_Manager();
     ~MyNVS_Manager();
     void close(int8_t index);
+    int add_watcher(watcher_t&& watcher);
 
     static bool             m_init_flag;
     std::mutex              m_mutex;
     static std::mutex       m_instance_mutex;
     static MyNVS_Manager*   m_nvs_manager;
     my_nvs_t                m_nvs[CONFIG_MAX_NAMESPACE];
+    std::mutex              m_watch_mutex;
+    std::vector<watcher_t>  m_watchers;
+    std::atomic<int>        m_watch_count{0};
+    int                     m_next_watch_id = 0;
 };
\ No newline at end of file
@@ -0,0 +1,100 @@
+/*
+ *             Copyright [2025] [samllin]
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *        http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+
+#pragma once
+
+#include <map>
+#include <set>
+#include <string>
+#include <vector>
+#include <cstdint>
+#include <initializer_list>
+#include "nvs_flash.h"
+
+// 声明式的名字空间结构迁移：按版本分组的步骤列表，由MyNVS::migrate在启动时执行
+//
+//  MyNVS_Migration migration;
+//  migration.version(1).rename("vol", "volume").erase("old")
+//           .version(2).retype("volume", NVS_TYPE_U16).split("rgb", {{"r", NVS_TYPE_U8}, {"g", NVS_TYPE_U8}, {"b", NVS_TYPE_U8}});
+//  nvs.migrate(migration);
+//
+// 规则：
+//  1. 版本号记录在名字空间的SCHEMA_KEY(u32)中，不存在视为0，已是最新版本时只需一次读取
+//  2. 每个版本的步骤在内存中依次执行，成功后整批写入、更新版本号并提交一次
+//  3. 源键不存在时跳过该步骤，步骤出错时该版本不写入Flash，写入中途失败时恢复该版本涉及的键
+//  4. 数值按原始字节处理：整数为小端原始宽度，字符串不含结尾'\0'
+class MyNVS_Migration {
+public:
+    static constexpr const char* SCHEMA_KEY = "__schema";
+
+    struct target_t {
+        const char* key;
+        nvs_type_t  type;
+    };
+
+    // 开始一个新版本的步骤组，版本号须严格递增且大于0
+    MyNVS_Migration& version(uint32_t version);
+    // 重命名键，目标键已存在时被覆盖
+    MyNVS_Migration& rename(const char* from, const char* to);
+    // 修改类型：整数之间转换（超出范围时报错），字符串与Blob互转
+    MyNVS_Migration& retype(const char* key, nvs_type_t type);
+    // 拆分：源值字节依次分配给目标键，整数目标按宽度取字节，字符串/Blob目标取剩余全部字节（须为最后一个）
+    MyNVS_Migration& split(const char* from, std::initializer_list<target_t> to);
+    // 合并：源值字节依次拼接后写入目标键，整数目标不足宽度时高位补0
+    MyNVS_Migration& merge(std::initializer_list<const char*> from, const char* to, nvs_type_t type);
+    // 删除键
+    MyNVS_Migration& erase(const char* key);
+
+    uint32_t latest() const {
+        return m_groups.empty() ? 0 : m_groups.back().version;
+    }
+    bool valid() const {
+        return m_valid;
+    }
+
+private:
+    friend class MyNVS;
+
+    enum class op_t { RENAME, RETYPE, SPLIT, MERGE, ERASE };
+    struct step_t {
+        op_t                        op;
+        std::vector<std::string>    from;
+        std::vector<std::string>    to;
+        std::vector<nvs_type_t>     types;
+    };
+    struct group_t {
+        uint32_t            version;
+        std::vector<step_t> steps;
+    };
+    struct value_t {
+        nvs_type_t              type;
+        std::vector<uint8_t>    data;   // 整数为小端原始宽度，字符串含结尾'\0'
+    };
+    // 迁移过程中的名字空间内存视图及变更记录
+    struct store_t {
+        std::map<std::string, value_t>  values;
+        std::set<std::string>           dirty;
+        std::set<std::string>           erased;
+        void set(const std::string& key, value_t&& value);
+        void remove(const std::string& key);
+    };
+
+    MyNVS_Migration& add(step_t&& step);
+    esp_err_t apply(const group_t& group, store_t& store) const;
+
+    std::vector<group_t>    m_groups;
+    bool                    m_valid = true;
+};
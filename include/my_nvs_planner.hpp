@@ -0,0 +1,91 @@
+/*
+ *             Copyright [2025] [samllin]
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *        http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+
+#pragma once
+
+#include <cstddef>
+#include "my_nvs.hpp"
+
+// 容量统计
+struct my_nvs_capacity_t {
+    size_t  required_entries;   // 计划写入所需条目数
+    size_t  reserve_entries;    // 变长数据跨页时最坏情况下浪费的条目数
+    size_t  available_entries;  // 分区可用条目数（已扣除垃圾回收保留页）
+    size_t  free_entries;       // 分区空闲条目数
+    size_t  used_entries;       // 分区已用条目数
+    size_t  total_entries;      // 分区总条目数
+    size_t  namespace_entries;  // 本名字空间已用条目数
+    size_t  namespace_count;    // 分区内名字空间数量
+    float   reserve_ratio;      // 跨页预留占可用条目的比例：reserve_entries / available_entries
+};
+
+// 写入计划：按NVS条目规则累计一组待写入数据所需的条目数，不访问Flash
+class MyNVS_Planner {
+public:
+    // NVS条目规则：每个条目32字节，每页126个条目，变长数据（字符串、Blob分块）须位于同一页内
+    static constexpr size_t ENTRY_SIZE = 32;
+    static constexpr size_t PAGE_ENTRIES = 126;
+    static constexpr size_t ITEM_MAX_DATA = (PAGE_ENTRIES - 1) * ENTRY_SIZE;
+
+    template <StorableType T>
+    MyNVS_Planner& add(const T& value);
+    MyNVS_Planner& add(const char* value) {
+        return add_string(value ? strlen(value) : 0);
+    }
+    MyNVS_Planner& add(const std::string& value) {
+        return add_string(value.size());
+    }
+    MyNVS_Planner& add_items(size_t count = 1);
+    MyNVS_Planner& add_string(size_t length);
+    MyNVS_Planner& add_blob(size_t length);
+    void clear();
+
+    // 计划所需条目数
+    size_t entries() const {
+        return m_entries;
+    }
+    // 单个数据项占用的最大连续条目数
+    size_t max_span() const {
+        return m_max_span;
+    }
+    // 跨页碎片的最坏情况预留条目数
+    size_t reserve() const;
+
+    static size_t string_entries(size_t length);
+    static size_t blob_entries(size_t length);
+
+private:
+    void add_span(size_t entries, size_t span);
+
+    size_t  m_entries = 0;
+    size_t  m_max_span = 0;
+};
+
+template <StorableType T>
+MyNVS_Planner& MyNVS_Planner::add(const T& value)
+{
+    if constexpr(ArrayType<T>) {
+        constexpr size_t size = sizeof(typename T::value_type) * std::tuple_size_v<T>;
+        return size <= sizeof(uint64_t) ? add_items() : add_blob(size);
+    } else if constexpr(VectorType<T>) {
+        return add_blob(value.size() * sizeof(typename T::value_type));
+    } else if constexpr(OptionalType<T>) {
+        // 空值对应删除，不占用新条目
+        return value.has_value() ? add(*value) : *this;
+    } else {
+        return add_items();
+    }
+}
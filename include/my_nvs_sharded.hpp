@@ -0,0 +1,115 @@
+/*
+ *             Copyright [2025] [samllin]
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *        http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+
+#pragma once
+
+#include <atomic>
+#include <memory>
+#include <string>
+#include <vector>
+#include <functional>
+#include <initializer_list>
+#include "my_nvs.hpp"
+
+// 分片负载统计
+struct my_nvs_shard_stats_t {
+    std::string partition;      // 分区名
+    std::string name_space;     // 名字空间
+    uint32_t    reads;          // 读取次数
+    uint32_t    writes;         // 写入/删除次数
+    size_t      entries;        // 已用条目数
+};
+
+// 分片名字空间：按键名的稳定哈希(FNV-1a)将键分散到多个分区或名字空间，
+// 每个分片拥有独立的槽位锁和Flash页面，以分散锁竞争和磨损
+// 注意：每个分片占用一个槽位，分片数不应超过CONFIG_MAX_NAMESPACE减去其他已打开的名字空间数
+//       组件只自动初始化默认分区，跨分区分片前须先对其他分区调用nvs_flash_init_partition
+//       分片数为0（参数无效）时读写接口返回ESP_FAIL
+class MyNVS_Sharded {
+public:
+    // 跨分区分片：每个分区中打开同名名字空间
+    MyNVS_Sharded(std::initializer_list<const char*> partitions, const char* name_space, nvs_open_mode_t mode = NVS_READONLY);
+    // 单分区分片：在partition中打开name_space0 ~ name_space<count-1>
+    MyNVS_Sharded(const char* partition, const char* name_space, size_t count, nvs_open_mode_t mode = NVS_READONLY);
+
+    // 全部分片均打开成功
+    bool opened() const;
+    size_t count() const {
+        return m_shards.size();
+    }
+    // 键所在的分片序号，按NVS截断后的键名计算，与分片数以外的因素无关
+    size_t shard_of(const char* key) const;
+    // 键所在分片的MyNVS，无分片时返回nullptr
+    MyNVS* shard(const char* key) {
+        return m_shards.empty() ? nullptr : m_shards[shard_of(key)]->nvs.get();
+    }
+
+    template <StorableType T>
+    esp_err_t read(const char* key, T& value) {
+        auto nvs = route(key, false);
+        return nvs ? nvs->read(key, value) : ESP_FAIL;
+    }
+    template <StorableType T>
+    esp_err_t write(const char* key, const T& value) {
+        auto nvs = route(key, true);
+        return nvs ? nvs->write(key, value) : ESP_FAIL;
+    }
+    esp_err_t read(const char* key, std::string& value) {
+        auto nvs = route(key, false);
+        return nvs ? nvs->read(key, value) : ESP_FAIL;
+    }
+    esp_err_t read(const char* key, void* value, size_t* length) {
+        auto nvs = route(key, false);
+        return nvs ? nvs->read(key, value, length) : ESP_FAIL;
+    }
+    esp_err_t write(const char* key, const char* value) {
+        auto nvs = route(key, true);
+        return nvs ? nvs->write(key, value) : ESP_FAIL;
+    }
+    esp_err_t write(const char* key, const std::string& value) {
+        auto nvs = route(key, true);
+        return nvs ? nvs->write(key, value) : ESP_FAIL;
+    }
+    esp_err_t write(const char* key, const void* value, size_t length) {
+        auto nvs = route(key, true);
+        return nvs ? nvs->write(key, value, length) : ESP_FAIL;
+    }
+    esp_err_t find(const char* key, nvs_type_t* out_type = nullptr);
+    esp_err_t erase_key(const char* key);
+
+    // 提交全部分片，返回第一个错误（其余分片仍会提交）
+    esp_err_t commit_all();
+    // 遍历全部分片的键，回调参数为分片序号及条目信息
+    esp_err_t for_each(const std::function<void(size_t shard, const nvs_entry_info_t& info)>& visitor, nvs_type_t type = NVS_TYPE_ANY);
+    // 各分片的读写次数及条目用量，用于检查分布是否均衡
+    esp_err_t stats(std::vector<my_nvs_shard_stats_t>& out);
+    void reset_stats();
+
+private:
+    struct shard_t {
+        std::unique_ptr<MyNVS>  nvs;
+        std::string             partition;
+        std::string             name_space;
+        std::atomic<uint32_t>   reads{0};
+        std::atomic<uint32_t>   writes{0};
+    };
+
+    void add_shard(const char* partition, const char* name_space, nvs_open_mode_t mode);
+    // 选择键所在分片并计数，无分片时返回nullptr
+    MyNVS* route(const char* key, bool write);
+
+    std::vector<std::unique_ptr<shard_t>> m_shards;
+};
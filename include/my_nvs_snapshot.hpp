@@ -0,0 +1,87 @@
+/*
+ *             Copyright [2025] [samllin]
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *        http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+
+#pragma once
+
+#include <string>
+#include <vector>
+#include <memory>
+#include <functional>
+#include "nvs_flash.h"
+#include "my_nvs.hpp"
+
+// 名字空间的不可变快照：键有序排列，读取为纯内存二分查找，不加锁、不访问Flash
+class MyNVS_Snapshot {
+public:
+    // 遍历回调：data/length为值的原始字节（整数为小端原始宽度，字符串含结尾'\0'）
+    using visitor_t = std::function<void(const char* key, nvs_type_t type, const void* data, size_t length)>;
+
+    // 通过名字空间迭代器加载句柄内的全部键值，调用方须持有对应槽位锁
+    static esp_err_t load(nvs_handle_t handle, std::shared_ptr<const MyNVS_Snapshot>& out);
+
+    template <SupportedType T>
+    esp_err_t read(const char* key, T& value) const;
+    esp_err_t read(const char* key, std::string& value) const;
+    esp_err_t read(const char* key, void* value, size_t* length) const;
+    esp_err_t find(const char* key, nvs_type_t* out_type = nullptr) const;
+    void for_each(const visitor_t& visitor) const;
+    size_t size() const {
+        return m_entries.size();
+    }
+
+private:
+    struct entry_t {
+        char        key[NVS_KEY_NAME_MAX_SIZE];
+        nvs_type_t  type;
+        uint32_t    length;     // 值长度（字节）
+        uint64_t    value;      // 整数的原始值，字符串/Blob为在m_pool中的偏移
+    };
+
+    MyNVS_Snapshot() = default;
+    const entry_t* lookup(const char* key) const;
+    const void* data_of(const entry_t& entry) const;
+    // 类型擦除的原生类型读取核心
+    esp_err_t read_item(const char* key, nvs_type_t type, void* out) const;
+
+    std::vector<entry_t> m_entries;
+    std::vector<uint8_t> m_pool;
+};
+
+// 读者端的快照缓存，每个任务各持有一个，不可跨任务共享
+// get()通常只有一次版本号原子读取，快照发布后首次调用才重新获取shared_ptr
+class MyNVS_SnapshotReader {
+public:
+    explicit MyNVS_SnapshotReader(MyNVS& nvs);
+    // 返回当前快照，未开启快照模式时返回nullptr；指针在下一次get()之前有效
+    const MyNVS_Snapshot* get();
+
+private:
+    MyNVS&                                  m_nvs;
+    std::shared_ptr<const MyNVS_Snapshot>   m_snapshot;
+    uint32_t                                m_version = 0;
+    bool                                    m_loaded = false;
+};
+
+template <SupportedType T>
+esp_err_t MyNVS_Snapshot::read(const char* key, T& value) const
+{
+    nvs_storage_t<T> tmp{};
+    auto err = read_item(key, nvs_type_of<nvs_storage_t<T>>(), &tmp);
+    if (ESP_OK == err) {
+        value = nvs_from_storage<T>(tmp);
+    }
+    return err;
+}
@@ -0,0 +1,59 @@
+/*
+ *             Copyright [2025] [samllin]
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *        http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+
+#pragma once
+
+#include "sdkconfig.h"
+
+#if CONFIG_MYNVS_WARM_CACHE
+#include <cstdint>
+#include "nvs.h"
+
+struct my_nvs_warm_cache_stats_t {
+    uint32_t    hits;           // 本次启动以来的命中次数
+    uint32_t    misses;         // 本次启动以来的未命中次数
+    uint32_t    generation;     // 区域代数，每次名字空间失效/重新登记/整体清空时递增
+    uint32_t    entries;        // 当前有效条目数
+    bool        restored;       // 启动时是否沿用了保留内存中的缓存
+};
+
+// 保留内存热缓存：整数类型的值（含打包的小数组、枚举、浮点等）保存在RTC no-init内存中，
+// 深度睡眠唤醒或软件复位后无需访问Flash即可读取；主机(Linux)目标上以普通静态内存模拟
+//  1. 每个条目及区域头部各带CRC32，上电/看门狗等不可信的复位原因、或NVS分区被擦除时整体清空
+//  2. 写入/删除前先使该键失效，erase_all使整个名字空间失效
+//  3. 每个名字空间的Flash代数保存在同一分区的"mynvs_wcgen"名字空间中，打开时只读取，有修改的名字空间在commit成功后递增并写入；
+//     打开名字空间时与保留内存中的记录比较，不一致或无记录时丢弃该名字空间的全部条目，无记录时由下一次commit写入
+//  4. 每个键固定映射到一个4路组，查找为O(1)；读取按组的序列号无锁进行，修改时加锁；所有接口线程安全
+class MyNVS_WarmCache {
+public:
+    // 启动时由MyNVS_Manager调用：校验保留区域，flash_erased为true时直接清空
+    static void init(bool flash_erased);
+    // 名字空间标识（分区名+名字空间的哈希，不为0）
+    static uint32_t namespace_id(const char* partition, const char* name_space);
+    // 打开名字空间时由MyNVS_Manager调用：只读地校验Flash代数，返回名字空间标识
+    static uint32_t attach(const char* partition, const char* name_space);
+    // 以读写模式提交成功后调用（含MyNVS_Manager关闭名字空间时的提交）：名字空间有修改或Flash中无记录时递增并保存Flash代数
+    static void commit(uint32_t ns, const char* partition, const char* name_space);
+
+    static bool lookup(uint32_t ns, const char* key, nvs_type_t type, void* out);
+    static void store(uint32_t ns, const char* key, nvs_type_t type, const void* value);
+    static void invalidate(uint32_t ns, const char* key);
+    static void invalidate_namespace(uint32_t ns);
+    static void clear();
+    static my_nvs_warm_cache_stats_t stats();
+};
+
+#endif
@@ -32,6 +32,10 @@
 
 #include <vector>
 #include "my_nvs.hpp"
+#include "my_nvs_log.hpp"
+#include "my_nvs_snapshot.hpp"
+#include "my_nvs_planner.hpp"
+#include "my_nvs_warm_cache.hpp"
 
 #define TAG "MyNVS"
 
@@ -42,13 +46,13 @@ MyNVS::MyNVS(const char* name_space, nvs_open_mode_t mode)
     if (strlen(name_space) > NAMESPACE_LENGTH) {
         strncpy(safe_namespace, name_space, NAMESPACE_LENGTH);
         safe_namespace[NAMESPACE_LENGTH] = '\0';
-        ESP_LOGW(TAG, "namespace name is too loog, original namespace=%s, use namespace=%s now, may be cause error!", name_space, safe_namespace);
+        MYNVS_LOGW(TAG, "namespace name is too loog, original namespace=%s, use namespace=%s now, may be cause error!", name_space, safe_namespace);
         name_space = safe_namespace;
     }
     auto index = m_manager->open("nvs", name_space, mode);
     if (index == INVALID_INDEX) {
         m_nvs = nullptr;
-        ESP_LOGE(TAG, "打开分区失败");
+        MYNVS_LOGE(TAG, "打开分区失败");
         return;
     }
         
@@ -62,15 +66,15 @@ MyNVS::MyNVS(const char* partition, const char* name_space, nvs_open_mode_t mode
     if (strlen(name_space) > NAMESPACE_LENGTH) {
         strncpy(safe_namespace, name_space, NAMESPACE_LENGTH);
         safe_namespace[NAMESPACE_LENGTH] = '\0';
-        ESP_LOGW(TAG, "namespace name is too loog, original namespace=%s, use namespace=%s now, may be cause error!", name_space, safe_namespace);
+        MYNVS_LOGW(TAG, "namespace name is too loog, original namespace=%s, use namespace=%s now, may be cause error!", name_space, safe_namespace);
         name_space = safe_namespace;
     }
     char safe_partition_name[PARTITION_LENGTH + 1];
     if (strlen(partition) > PARTITION_LENGTH) {
         strncpy(safe_partition_name, partition, PARTITION_LENGTH);
         safe_partition_name[PARTITION_LENGTH] = '\0';
-        ESP_LOGW(TAG, "namespace name length is too loog, use namespace=%s, may be cause error!", partition);
-        ESP_LOGW(TAG, "partition name is too loog, original partition=%s, use partition=%s now, may be cause error!", partition, safe_partition_name);
+        MYNVS_LOGW(TAG, "namespace name length is too loog, use namespace=%s, may be cause error!", partition);
+        MYNVS_LOGW(TAG, "partition name is too loog, original partition=%s, use partition=%s now, may be cause error!", partition, safe_partition_name);
         partition = safe_partition_name;
     }
 
@@ -80,7 +84,7 @@ MyNVS::MyNVS(const char* partition, const char* name_space, nvs_open_mode_t mode
         m_nvs = m_manager->get_nvs(index);
     } else {
         m_nvs = nullptr;
-        ESP_LOGE(TAG, "打开分区失败");
+        MYNVS_LOGE(TAG, "打开分区失败");
     }
 }
 
@@ -94,161 +98,450 @@ MyNVS::~MyNVS()
 }
 
 // =============================================
-// 非模板成员函数实现
+// 共享的校验、加锁及类型擦除核心
 // =============================================
 
-// --- 字符串读取 ---
-esp_err_t MyNVS::read(const char* key, char* value)
+esp_err_t MyNVS::lock_slot(std::unique_lock<std::mutex>& lock, bool write)
 {
-    if (key == nullptr || *key == '\0' || value == nullptr) {
-        ESP_LOGE(TAG, "键名为空/保存地址为空");
-        return ESP_ERR_INVALID_ARG;
+    if (!m_nvs) {
+        MYNVS_LOGE(TAG, "NVS未正确打开或实例已失效");
+        return ESP_FAIL;
     }
-    if(!m_nvs) {
-        ESP_LOGE(TAG, "NVS未正确打开或实例已失效");
+    if (write && m_nvs->open_mode != NVS_READWRITE) {
+        MYNVS_LOGE(TAG, "NVS只读或未打开");
         return ESP_FAIL;
     }
-
-    std::unique_lock<std::mutex> lock(m_nvs->mutex, std::try_to_lock);
-    if(!lock.owns_lock() || !is_valid()) {
-        ESP_LOGE(TAG, "NVS未正确打开或实例已失效");
+    lock = std::unique_lock<std::mutex>(m_nvs->mutex, std::try_to_lock);
+    if (!lock.owns_lock() || !is_valid()) {
+        MYNVS_LOGE(TAG, "尝试加锁失败或NVS已关闭");
         return ESP_FAIL;
     }
-    size_t len = 0;
-    auto err = nvs_get_str(m_nvs->handle, key, nullptr, &len);
-    return err == ESP_OK ? nvs_get_str(m_nvs->handle, key, value, &len) : err; 
+    return ESP_OK;
 }
 
-esp_err_t MyNVS::read(const char* key, std::string &value)
+esp_err_t MyNVS::check_key(const char*& key, char* safe_key)
 {
     if (key == nullptr || *key == '\0') {
-        ESP_LOGE(TAG, "键名为空");
+        MYNVS_LOGE(TAG, "键名为空");
         return ESP_ERR_INVALID_ARG;
     }
-    char safe_key[KEY_LENGTH + 1];
-    if (strlen(key) > KEY_LENGTH) {
+    // 只扫描到KEY_LENGTH+1，常见的短键名无需完整strlen
+    if (strnlen(key, KEY_LENGTH + 1) > KEY_LENGTH) {
         strncpy(safe_key, key, KEY_LENGTH);
         safe_key[KEY_LENGTH] = '\0';
-        ESP_LOGW(TAG, "key length is too loog, original key=%s key=%s, may be cause error!", key, safe_key);
+        MYNVS_LOGW(TAG, "key length is too loog, original key=%s key=%s, may be cause error!", key, safe_key);
         key = safe_key;
     }
-    
-    if(!m_nvs) {
-        ESP_LOGE(TAG, "NVS未正确打开或实例已失效");
-        return ESP_FAIL;
+    return ESP_OK;
+}
+
+esp_err_t MyNVS::lock_key(const char*& key, char* safe_key, std::unique_lock<std::mutex>& lock, bool write)
+{
+    auto err = check_key(key, safe_key);
+    return err == ESP_OK ? lock_slot(lock, write) : err;
+}
+
+// 保留内存热缓存（CONFIG_MYNVS_WARM_CACHE），未启用时为空操作；调用方须持有槽位锁，修改Flash前先失效
+static inline bool cache_lookup([[maybe_unused]] const my_nvs_t* nvs, [[maybe_unused]] const char* key,
+    [[maybe_unused]] nvs_type_t type, [[maybe_unused]] void* out)
+{
+#if CONFIG_MYNVS_WARM_CACHE
+    return MyNVS_WarmCache::lookup(nvs->cache_id, key, type, out);
+#else
+    return false;
+#endif
+}
+
+static inline void cache_store([[maybe_unused]] const my_nvs_t* nvs, [[maybe_unused]] const char* key,
+    [[maybe_unused]] nvs_type_t type, [[maybe_unused]] const void* value)
+{
+#if CONFIG_MYNVS_WARM_CACHE
+    MyNVS_WarmCache::store(nvs->cache_id, key, type, value);
+#endif
+}
+
+// key为nullptr时使整个名字空间失效
+static inline void cache_invalidate([[maybe_unused]] const my_nvs_t* nvs, [[maybe_unused]] const char* key)
+{
+#if CONFIG_MYNVS_WARM_CACHE
+    if (key == nullptr) {
+        MyNVS_WarmCache::invalidate_namespace(nvs->cache_id);
+    } else {
+        MyNVS_WarmCache::invalidate(nvs->cache_id, key);
     }
-    std::unique_lock<std::mutex> lock(m_nvs->mutex, std::try_to_lock);
-    if(!lock.owns_lock() || !is_valid()) {
-        ESP_LOGE(TAG, "NVS未正确打开或实例已失效");
-        return ESP_FAIL;
+#endif
+}
+
+// 提交成功后递增有修改的名字空间的Flash代数，只读打开的名字空间不写入Flash
+static inline void cache_commit([[maybe_unused]] const my_nvs_t* nvs)
+{
+#if CONFIG_MYNVS_WARM_CACHE
+    if (nvs->open_mode == NVS_READWRITE) {
+        MyNVS_WarmCache::commit(nvs->cache_id, nvs->partition.c_str(), nvs->name_space.c_str());
     }
+#endif
+}
 
-    size_t len = 0;
-    auto err = nvs_get_str(m_nvs->handle, key, nullptr, &len);
+// 合并事件：同一键只保留最后一次事件，名字空间级事件只保留一次
+static void merge_event(std::vector<my_nvs_event_t>& events, const my_nvs_event_t& event)
+{
+    bool key_event = (event.type == MY_NVS_EVENT_WRITE || event.type == MY_NVS_EVENT_ERASE);
+    for (auto &pending : events) {
+        bool pending_key_event = (pending.type == MY_NVS_EVENT_WRITE || pending.type == MY_NVS_EVENT_ERASE);
+        if (key_event ? (pending_key_event && strcmp(pending.key, event.key) == 0) : (pending.type == event.type)) {
+            pending.type = event.type;
+            return;
+        }
+    }
+    events.push_back(event);
+}
+
+namespace mynvs_detail {
+template <typename S>
+esp_err_t get(nvs_handle_t handle, const char* key, void* out)
+{
+    auto value = static_cast<S*>(out);
+    if constexpr(std::is_same_v<S, uint8_t>)        return nvs_get_u8(handle, key, value);
+    else if constexpr(std::is_same_v<S, int8_t>)    return nvs_get_i8(handle, key, value);
+    else if constexpr(std::is_same_v<S, uint16_t>)  return nvs_get_u16(handle, key, value);
+    else if constexpr(std::is_same_v<S, int16_t>)   return nvs_get_i16(handle, key, value);
+    else if constexpr(std::is_same_v<S, uint32_t>)  return nvs_get_u32(handle, key, value);
+    else if constexpr(std::is_same_v<S, int32_t>)   return nvs_get_i32(handle, key, value);
+    else if constexpr(std::is_same_v<S, uint64_t>)  return nvs_get_u64(handle, key, value);
+    else                                            return nvs_get_i64(handle, key, value);
+}
+
+template <typename S>
+esp_err_t set(nvs_handle_t handle, const char* key, uint64_t bits)
+{
+    auto value = static_cast<S>(bits);
+    if constexpr(std::is_same_v<S, uint8_t>)        return nvs_set_u8(handle, key, value);
+    else if constexpr(std::is_same_v<S, int8_t>)    return nvs_set_i8(handle, key, value);
+    else if constexpr(std::is_same_v<S, uint16_t>)  return nvs_set_u16(handle, key, value);
+    else if constexpr(std::is_same_v<S, int16_t>)   return nvs_set_i16(handle, key, value);
+    else if constexpr(std::is_same_v<S, uint32_t>)  return nvs_set_u32(handle, key, value);
+    else if constexpr(std::is_same_v<S, int32_t>)   return nvs_set_i32(handle, key, value);
+    else if constexpr(std::is_same_v<S, uint64_t>)  return nvs_set_u64(handle, key, value);
+    else                                            return nvs_set_i64(handle, key, value);
+}
+
+// 每种存储类型各实例化一份，模板前端只引用其地址
+template esp_err_t get<uint8_t>(nvs_handle_t, const char*, void*);
+template esp_err_t get<int8_t>(nvs_handle_t, const char*, void*);
+template esp_err_t get<uint16_t>(nvs_handle_t, const char*, void*);
+template esp_err_t get<int16_t>(nvs_handle_t, const char*, void*);
+template esp_err_t get<uint32_t>(nvs_handle_t, const char*, void*);
+template esp_err_t get<int32_t>(nvs_handle_t, const char*, void*);
+template esp_err_t get<uint64_t>(nvs_handle_t, const char*, void*);
+template esp_err_t get<int64_t>(nvs_handle_t, const char*, void*);
+template esp_err_t set<uint8_t>(nvs_handle_t, const char*, uint64_t);
+template esp_err_t set<int8_t>(nvs_handle_t, const char*, uint64_t);
+template esp_err_t set<uint16_t>(nvs_handle_t, const char*, uint64_t);
+template esp_err_t set<int16_t>(nvs_handle_t, const char*, uint64_t);
+template esp_err_t set<uint32_t>(nvs_handle_t, const char*, uint64_t);
+template esp_err_t set<int32_t>(nvs_handle_t, const char*, uint64_t);
+template esp_err_t set<uint64_t>(nvs_handle_t, const char*, uint64_t);
+template esp_err_t set<int64_t>(nvs_handle_t, const char*, uint64_t);
+
+// 运行期类型到存储类型的映射
+static const scalar_ops_t* find_ops(nvs_type_t type)
+{
+    switch (type) {
+        case NVS_TYPE_U8:   return &scalar_ops<uint8_t>;
+        case NVS_TYPE_I8:   return &scalar_ops<int8_t>;
+        case NVS_TYPE_U16:  return &scalar_ops<uint16_t>;
+        case NVS_TYPE_I16:  return &scalar_ops<int16_t>;
+        case NVS_TYPE_U32:  return &scalar_ops<uint32_t>;
+        case NVS_TYPE_I32:  return &scalar_ops<int32_t>;
+        case NVS_TYPE_U64:  return &scalar_ops<uint64_t>;
+        case NVS_TYPE_I64:  return &scalar_ops<int64_t>;
+        default:            return nullptr;
+    }
+}
+
+esp_err_t get_integer(nvs_handle_t handle, const char* key, nvs_type_t type, void* out)
+{
+    auto ops = find_ops(type);
+    return ops ? ops->get(handle, key, out) : ESP_ERR_NOT_SUPPORTED;
+}
+}
+
+// 发布新快照后递增版本号，MyNVS_SnapshotReader据此判断是否需要重新获取
+static void publish_snapshot(my_nvs_t* slot, std::shared_ptr<const MyNVS_Snapshot> snapshot)
+{
+    slot->snapshot.store(std::move(snapshot), std::memory_order_release);
+    slot->snapshot_version.fetch_add(1, std::memory_order_release);
+}
+
+// 运行期类型的整数写入，仅供镜像导入与迁移使用
+static esp_err_t set_item(nvs_handle_t handle, const char* key, nvs_type_t type, uint64_t bits)
+{
+    auto ops = mynvs_detail::find_ops(type);
+    auto err = ops ? ops->set(handle, key, bits) : ESP_ERR_NOT_SUPPORTED;
     if (err != ESP_OK) {
-        return err;
-    } else {
-        if(len == 0) {
-            value.clear();
-            return ESP_OK;
+        MYNVS_LOGE(TAG, "写入%s失败: %s", key, esp_err_to_name(err));
+    }
+    return err;
+}
+
+esp_err_t MyNVS::check_value(nvs_type_t type, const void* data, size_t length)
+{
+    size_t width = nvs_integer_size(type);
+    if (width != 0) {
+        return length == width ? ESP_OK : ESP_ERR_NVS_INVALID_LENGTH;
+    } else if (type == NVS_TYPE_STR) {
+        // 须以'\0'结尾
+        if (length == 0 || static_cast<const char*>(data)[length - 1] != '\0') {
+            return ESP_ERR_NVS_INVALID_LENGTH;
         }
+        return ESP_OK;
+    } else if (type == NVS_TYPE_BLOB) {
+        return ESP_OK;
     }
+    return ESP_ERR_NOT_SUPPORTED;
+}
 
-    value.resize(len - 1);
-    return nvs_get_str(m_nvs->handle, key, value.data(), &len);
+esp_err_t MyNVS::set_value(nvs_handle_t handle, const char* key, nvs_type_t type, const void* data, size_t length)
+{
+    auto err = check_value(type, data, length);
+    if (err != ESP_OK) {
+        return err;
+    }
+    size_t width = nvs_integer_size(type);
+    if (width != 0) {
+        uint64_t bits = 0;
+        memcpy(&bits, data, width);
+        return set_item(handle, key, type, bits);
+    } else if (type == NVS_TYPE_STR) {
+        return nvs_set_str(handle, key, static_cast<const char*>(data));
+    }
+    return nvs_set_blob(handle, key, data, length);
 }
 
-// --- Blob读取 ---
-esp_err_t MyNVS::read(const char* key, void* value, size_t* length)
+esp_err_t MyNVS::read_item(const char* key, const mynvs_detail::scalar_ops_t& ops, void* out)
 {
-    if (key == nullptr || *key == '\0') {
-        ESP_LOGE(TAG, "键名为空");
-        return ESP_ERR_INVALID_ARG;
+    char safe_key[KEY_LENGTH + 1];
+    std::unique_lock<std::mutex> lock;
+    auto err = lock_key(key, safe_key, lock, false);
+    if (err != ESP_OK) {
+        return err;
+    }
+    if (cache_lookup(m_nvs, key, ops.type, out)) {
+        return ESP_OK;
     }
+    err = ops.get(m_nvs->handle, key, out);
+    if (err == ESP_OK) {
+        cache_store(m_nvs, key, ops.type, out);
+    }
+    return err;
+}
+
+esp_err_t MyNVS::write_item(const char* key, const mynvs_detail::scalar_ops_t& ops, uint64_t bits)
+{
     char safe_key[KEY_LENGTH + 1];
-    if (strlen(key) > KEY_LENGTH) {
-        strncpy(safe_key, key, KEY_LENGTH);
-        safe_key[KEY_LENGTH] = '\0';
-        ESP_LOGW(TAG, "key length is too loog, original key=%s key=%s, may be cause error!", key, safe_key);
-        key = safe_key;
+    std::unique_lock<std::mutex> lock;
+    auto err = lock_key(key, safe_key, lock, true);
+    if (err != ESP_OK) {
+        return err;
     }
-    
-    if(!m_nvs) {
-        ESP_LOGE(TAG, "NVS未正确打开或实例已失效");
-        return ESP_FAIL;
+    cache_invalidate(m_nvs, key);
+    err = ops.set(m_nvs->handle, key, bits);
+    lock.unlock();
+    if (err == ESP_OK) {
+        notify(MY_NVS_EVENT_WRITE, key);
+    } else {
+        MYNVS_LOGE(TAG, "写入%s失败: %s", key, esp_err_to_name(err));
     }
-    std::unique_lock<std::mutex> lock(m_nvs->mutex, std::try_to_lock);
-    if(!lock.owns_lock() || !is_valid()) {
-        ESP_LOGE(TAG, "NVS未正确打开或实例已失效");
-        return ESP_FAIL;
+    return err;
+}
+
+esp_err_t MyNVS::read_items(const char* const* keys, const mynvs_detail::scalar_ops_t* const* ops, void* const* outs, esp_err_t* errs, size_t count)
+{
+    std::unique_lock<std::mutex> lock;
+    auto err = lock_slot(lock, false);
+    for (size_t i = 0; i < count; i++) {
+        if (err != ESP_OK) {
+            errs[i] = err;
+            continue;
+        }
+        char safe_key[KEY_LENGTH + 1];
+        const char* key = keys[i];
+        errs[i] = check_key(key, safe_key);
+        if (errs[i] == ESP_OK && !cache_lookup(m_nvs, key, ops[i]->type, outs[i])) {
+            errs[i] = ops[i]->get(m_nvs->handle, key, outs[i]);
+            if (errs[i] == ESP_OK) {
+                cache_store(m_nvs, key, ops[i]->type, outs[i]);
+            }
+        }
     }
-    auto err = nvs_get_blob(m_nvs->handle, key, value, length);
     return err;
 }
 
-// --- 字符串写入 ---
-esp_err_t MyNVS::write(const char* key, const char* value)
+esp_err_t MyNVS::write_items(const char* const* keys, const mynvs_detail::scalar_ops_t* const* ops, const uint64_t* bits, esp_err_t* errs, size_t count)
 {
-    if (key == nullptr || *key == '\0') {
-        ESP_LOGE(TAG, "键名为空");
-        return ESP_ERR_INVALID_ARG;
+    std::unique_lock<std::mutex> lock;
+    auto err = lock_slot(lock, true);
+    for (size_t i = 0; i < count; i++) {
+        if (err != ESP_OK) {
+            errs[i] = err;
+            continue;
+        }
+        char safe_key[KEY_LENGTH + 1];
+        const char* key = keys[i];
+        errs[i] = check_key(key, safe_key);
+        if (errs[i] == ESP_OK) {
+            cache_invalidate(m_nvs, key);
+            errs[i] = ops[i]->set(m_nvs->handle, key, bits[i]);
+            if (errs[i] != ESP_OK) {
+                MYNVS_LOGE(TAG, "写入%s失败: %s", key, esp_err_to_name(errs[i]));
+            }
+        }
+    }
+    if (err != ESP_OK) {
+        return err;
+    }
+    lock.unlock();
+    if (!m_manager->has_watchers()) {
+        return ESP_OK;
+    }
+    // 在本地合并后一并通知，通知中的键名按NVS长度截断，与实际写入的键一致
+    std::vector<my_nvs_event_t> events;
+    for (size_t i = 0; i < count; i++) {
+        if (errs[i] == ESP_OK) {
+            merge_event(events, MyNVS_Manager::make_event(m_nvs, MY_NVS_EVENT_WRITE, keys[i]));
+        }
     }
+    notify_events(events);
+    return ESP_OK;
+}
+
+esp_err_t MyNVS::read_blob(const char* key, blob_alloc_t alloc, void* ctx)
+{
     char safe_key[KEY_LENGTH + 1];
-    if (strlen(key) > KEY_LENGTH) {
-        strncpy(safe_key, key, KEY_LENGTH);
-        safe_key[KEY_LENGTH] = '\0';
-        ESP_LOGW(TAG, "key length is too loog, original key=%s key=%s, may be cause error!", key, safe_key);
-        key = safe_key;
+    std::unique_lock<std::mutex> lock;
+    auto err = lock_key(key, safe_key, lock, false);
+    if (err != ESP_OK) {
+        return err;
+    }
+    size_t length = 0;
+    err = nvs_get_blob(m_nvs->handle, key, nullptr, &length);
+    if (err != ESP_OK) {
+        return err;
+    }
+    void* buffer = alloc(ctx, length);
+    if (buffer == nullptr) {
+        MYNVS_LOGE(TAG, "读取%s失败: 数据长度%u与目标类型不匹配", key, static_cast<unsigned>(length));
+        return ESP_ERR_NVS_INVALID_LENGTH;
     }
-    
+    return length == 0 ? ESP_OK : nvs_get_blob(m_nvs->handle, key, buffer, &length);
+}
+
+// =============================================
+// 非模板成员函数实现
+// =============================================
+
+// --- 字符串读取 ---
+esp_err_t MyNVS::read(const char* key, char* value)
+{
     if (value == nullptr) {
-        ESP_LOGE(TAG, "写入数据指针为空");
+        MYNVS_LOGE(TAG, "键名为空/保存地址为空");
         return ESP_ERR_INVALID_ARG;
     }
-    
-    if (!m_nvs || m_nvs->open_mode != NVS_READWRITE) {
-        ESP_LOGE(TAG, "NVS只读或未打开");
-        return ESP_FAIL;
+    char safe_key[KEY_LENGTH + 1];
+    std::unique_lock<std::mutex> lock;
+    auto err = lock_key(key, safe_key, lock, false);
+    if (err != ESP_OK) {
+        return err;
     }
+    size_t len = 0;
+    err = nvs_get_str(m_nvs->handle, key, nullptr, &len);
+    return err == ESP_OK ? nvs_get_str(m_nvs->handle, key, value, &len) : err; 
+}
 
-    std::unique_lock<std::mutex> lock(m_nvs->mutex, std::try_to_lock);
-    if(!lock.owns_lock() || !is_valid()) {
-        ESP_LOGE(TAG, "NVS未正确打开或实例已失效");
-        return ESP_FAIL;
+esp_err_t MyNVS::read_str(const char* key, blob_alloc_t alloc, void* ctx)
+{
+    char safe_key[KEY_LENGTH + 1];
+    std::unique_lock<std::mutex> lock;
+    auto err = lock_key(key, safe_key, lock, false);
+    if (err != ESP_OK) {
+        return err;
+    }
+    size_t len = 0;
+    err = nvs_get_str(m_nvs->handle, key, nullptr, &len);
+    if (err != ESP_OK) {
+        return err;
+    }
+    void* buffer = alloc(ctx, len);
+    if (buffer == nullptr) {
+        MYNVS_LOGE(TAG, "读取%s失败: 无法分配%u字节", key, static_cast<unsigned>(len));
+        return ESP_ERR_NO_MEM;
     }
-    return nvs_set_str(m_nvs->handle, key, value);
+    return len == 0 ? ESP_OK : nvs_get_str(m_nvs->handle, key, static_cast<char*>(buffer), &len);
 }
 
-// --- Blob写入 ---
-esp_err_t MyNVS::write(const char* key, const void* value, size_t length)
+esp_err_t MyNVS::read(const char* key, std::string &value)
 {
-    if (key == nullptr || *key == '\0') {
-        ESP_LOGE(TAG, "键名为空");
+    return read_str(key, [](void* ctx, size_t length) -> void* {
+        auto& str = *static_cast<std::string*>(ctx);
+        str.resize(length > 0 ? length - 1 : 0);
+        return str.data();
+    }, &value);
+}
+
+// --- Blob读取 ---
+esp_err_t MyNVS::read(const char* key, void* value, size_t* length)
+{
+    char safe_key[KEY_LENGTH + 1];
+    std::unique_lock<std::mutex> lock;
+    auto err = lock_key(key, safe_key, lock, false);
+    if (err != ESP_OK) {
+        return err;
+    }
+    return nvs_get_blob(m_nvs->handle, key, value, length);
+}
+
+// --- 字符串写入 ---
+esp_err_t MyNVS::write(const char* key, const char* value)
+{
+    if (value == nullptr) {
+        MYNVS_LOGE(TAG, "写入数据指针为空");
         return ESP_ERR_INVALID_ARG;
     }
     char safe_key[KEY_LENGTH + 1];
-    if (strlen(key) > KEY_LENGTH) {
-        strncpy(safe_key, key, KEY_LENGTH);
-        safe_key[KEY_LENGTH] = '\0';
-        ESP_LOGW(TAG, "key length is too loog, original key=%s key=%s, may be cause error!", key, safe_key);
-        key = safe_key;
+    std::unique_lock<std::mutex> lock;
+    auto err = lock_key(key, safe_key, lock, true);
+    if (err != ESP_OK) {
+        return err;
     }
-    
+    cache_invalidate(m_nvs, key);
+    err = nvs_set_str(m_nvs->handle, key, value);
+    lock.unlock();
+    if (err == ESP_OK) {
+        notify(MY_NVS_EVENT_WRITE, key);
+    }
+    return err;
+}
+
+// --- Blob写入 ---
+esp_err_t MyNVS::write(const char* key, const void* value, size_t length)
+{
     if (value == nullptr) {
-        ESP_LOGE(TAG, "写入数据指针为空");
+        MYNVS_LOGE(TAG, "写入数据指针为空");
         return ESP_ERR_INVALID_ARG;
     }
-    
-    if (!m_nvs || m_nvs->open_mode != NVS_READWRITE) {
-        ESP_LOGE(TAG, "NVS只读或未打开");
-        return ESP_FAIL;
+    char safe_key[KEY_LENGTH + 1];
+    std::unique_lock<std::mutex> lock;
+    auto err = lock_key(key, safe_key, lock, true);
+    if (err != ESP_OK) {
+        return err;
     }
-    std::unique_lock<std::mutex> lock(m_nvs->mutex, std::try_to_lock);
-    if(!lock.owns_lock() || !is_valid()) {
-        ESP_LOGE(TAG, "NVS未正确打开或实例已失效");
-        return ESP_FAIL;
+    cache_invalidate(m_nvs, key);
+    err = nvs_set_blob(m_nvs->handle, key, value, length);
+    lock.unlock();
+    if (err == ESP_OK) {
+        notify(MY_NVS_EVENT_WRITE, key);
     }
-    return nvs_set_blob(m_nvs->handle, key, value, length);
+    return err;
 }
 
 
@@ -257,13 +550,6 @@ esp_err_t MyNVS::write(const char* key, const void* value, size_t length)
 esp_err_t MyNVS::find(const char* key)
 {
     nvs_type_t type;
-    char safe_key[KEY_LENGTH + 1];
-    if (strlen(key) > KEY_LENGTH) {
-        strncpy(safe_key, key, KEY_LENGTH);
-        safe_key[KEY_LENGTH] = '\0';
-        ESP_LOGW(TAG, "key length is too loog, original key=%s key=%s, may be cause error!", key, safe_key);
-        key = safe_key;
-    }
     return find(key, &type);
 }
 
@@ -280,54 +566,30 @@ esp_err_t MyNVS::find(const std::string& key, nvs_type_t* out_type)
 
 esp_err_t MyNVS::find(const char* key, nvs_type_t* out_type)
 {
-    if (key == nullptr || *key == '\0') {
-        ESP_LOGE(TAG, "键名为空");
-        return ESP_ERR_INVALID_ARG;
-    }
     char safe_key[KEY_LENGTH + 1];
-    if (strlen(key) > KEY_LENGTH) {
-        strncpy(safe_key, key, KEY_LENGTH);
-        safe_key[KEY_LENGTH] = '\0';
-        ESP_LOGW(TAG, "key length is too loog, original key=%s key=%s, may be cause error!", key, safe_key);
-        key = safe_key;
-    }
-    
-    if(!m_nvs) {
-        ESP_LOGE(TAG, "NVS未正确打开或实例已失效");
-        return ESP_FAIL;
-    }
-    std::unique_lock<std::mutex> lock(m_nvs->mutex, std::try_to_lock);
-    if(!lock.owns_lock() || !is_valid()) {
-        ESP_LOGE(TAG, "NVS未正确打开或实例已失效");
-        return ESP_FAIL;
+    std::unique_lock<std::mutex> lock;
+    auto err = lock_key(key, safe_key, lock, false);
+    if (err != ESP_OK) {
+        return err;
     }
     return nvs_find_key(m_nvs->handle, key, out_type);
 }
 
 esp_err_t MyNVS::erase_key(const char* key)
 {
-    if (key == nullptr || *key == '\0') {
-        ESP_LOGE(TAG, "键名为空");
-        return ESP_ERR_INVALID_ARG;
-    }
     char safe_key[KEY_LENGTH + 1];
-    if (strlen(key) > KEY_LENGTH) {
-        strncpy(safe_key, key, KEY_LENGTH);
-        safe_key[KEY_LENGTH] = '\0';
-        ESP_LOGW(TAG, "key length is too loog, original key=%s key=%s, may be cause error!", key, safe_key);
-        key = safe_key;
-    }
-    
-    if(!m_nvs) {
-        ESP_LOGE(TAG, "NVS未正确打开或实例已失效");
-        return ESP_FAIL;
+    std::unique_lock<std::mutex> lock;
+    auto err = lock_key(key, safe_key, lock, false);
+    if (err != ESP_OK) {
+        return err;
     }
-    std::unique_lock<std::mutex> lock(m_nvs->mutex, std::try_to_lock);
-    if(!lock.owns_lock() || !is_valid()) {
-        ESP_LOGE(TAG, "NVS未正确打开或实例已失效");
-        return ESP_FAIL;
+    cache_invalidate(m_nvs, key);
+    err = nvs_erase_key(m_nvs->handle, key);
+    lock.unlock();
+    if (err == ESP_OK) {
+        notify(MY_NVS_EVENT_ERASE, key);
     }
-    return nvs_erase_key(m_nvs->handle, key);
+    return err;
 }
 
 esp_err_t MyNVS::erase_key(const std::string& key)
@@ -337,28 +599,244 @@ esp_err_t MyNVS::erase_key(const std::string& key)
 
 esp_err_t MyNVS::erase_all()
 {
-    if(!m_nvs) {
-        ESP_LOGE(TAG, "NVS未正确打开或实例已失效");
-        return ESP_FAIL;
+    std::unique_lock<std::mutex> lock;
+    auto err = lock_slot(lock, false);
+    if (err != ESP_OK) {
+        return err;
     }
-    std::unique_lock<std::mutex> lock(m_nvs->mutex, std::try_to_lock);
-    if(!lock.owns_lock() || !is_valid()) {
-        ESP_LOGE(TAG, "NVS未正确打开或实例已失效");
-        return ESP_FAIL;
+    cache_invalidate(m_nvs, nullptr);
+    err = nvs_erase_all(m_nvs->handle);
+    lock.unlock();
+    if (err == ESP_OK) {
+        notify(MY_NVS_EVENT_ERASE_ALL, nullptr);
     }
-    return nvs_erase_all(m_nvs->handle);
+    return err;
 }
 
 esp_err_t MyNVS::commit()
 {
-    if(!m_nvs) {
-        ESP_LOGE(TAG, "NVS未正确打开或实例已失效");
-        return ESP_FAIL;
+    std::unique_lock<std::mutex> lock;
+    auto err = lock_slot(lock, false);
+    if (err != ESP_OK) {
+        return err;
     }
-    std::unique_lock<std::mutex> lock(m_nvs->mutex, std::try_to_lock);
-    if(!lock.owns_lock() || m_nvs->handle == 0) {
-        ESP_LOGE(TAG, "尝试加锁失败或NVS已关闭");
-        return ESP_FAIL;
+    err = nvs_commit(m_nvs->handle);
+    if (err == ESP_OK) {
+        cache_commit(m_nvs);
+    }
+    if (err == ESP_OK && m_nvs->snapshot_enabled) {
+        // 在锁内重新加载，保证发布的快照与提交状态一致；开关同样在锁内读写，disable后不会被重新发布
+        std::shared_ptr<const MyNVS_Snapshot> snapshot;
+        if (MyNVS_Snapshot::load(m_nvs->handle, snapshot) == ESP_OK) {
+            publish_snapshot(m_nvs, std::move(snapshot));
+        } else {
+            MYNVS_LOGW(TAG, "提交后刷新快照失败，继续使用旧快照");
+        }
+    }
+    lock.unlock();
+    if (err == ESP_OK) {
+        notify(MY_NVS_EVENT_COMMIT, nullptr);
+    }
+    return err;
+}
+
+esp_err_t MyNVS::for_each(const std::function<void(const nvs_entry_info_t& info)>& visitor, nvs_type_t type)
+{
+    std::vector<nvs_entry_info_t> entries;
+    {
+        std::unique_lock<std::mutex> lock;
+        auto err = lock_slot(lock, false);
+        if (err != ESP_OK) {
+            return err;
+        }
+        nvs_iterator_t it = nullptr;
+        err = nvs_entry_find_in_handle(m_nvs->handle, type, &it);
+        while (err == ESP_OK) {
+            nvs_entry_info_t info;
+            nvs_entry_info(it, &info);
+            entries.push_back(info);
+            err = nvs_entry_next(&it);
+        }
+        nvs_release_iterator(it);
+        if (err != ESP_ERR_NVS_NOT_FOUND) {
+            MYNVS_LOGE(TAG, "遍历名字空间失败: %s", esp_err_to_name(err));
+            return err;
+        }
+    }
+    for (auto &info : entries) {
+        visitor(info);
+    }
+    return ESP_OK;
+}
+
+// --- 空间预检 ---
+esp_err_t MyNVS::capacity(my_nvs_capacity_t* report)
+{
+    if (report == nullptr) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    std::unique_lock<std::mutex> lock;
+    auto err = lock_slot(lock, false);
+    if (err != ESP_OK) {
+        return err;
+    }
+    *report = {};
+    nvs_stats_t stats;
+    err = nvs_get_stats(m_nvs->partition.c_str(), &stats);
+    if (err == ESP_OK) {
+        err = nvs_get_used_entry_count(m_nvs->handle, &report->namespace_entries);
+    }
+    if (err != ESP_OK) {
+        MYNVS_LOGE(TAG, "获取分区%s统计信息失败: %s", m_nvs->partition.c_str(), esp_err_to_name(err));
+        return err;
+    }
+    report->available_entries = stats.available_entries;
+    report->free_entries = stats.free_entries;
+    report->used_entries = stats.used_entries;
+    report->total_entries = stats.total_entries;
+    report->namespace_count = stats.namespace_count;
+    return ESP_OK;
+}
+
+esp_err_t MyNVS::can_fit(const MyNVS_Planner& plan, my_nvs_capacity_t* report, bool replace_namespace)
+{
+    my_nvs_capacity_t capacity_report;
+    auto err = capacity(&capacity_report);
+    if (err != ESP_OK) {
+        return err;
+    }
+    if (replace_namespace) {
+        capacity_report.available_entries += capacity_report.namespace_entries;
+    }
+    capacity_report.required_entries = plan.entries();
+    capacity_report.reserve_entries = plan.reserve();
+    capacity_report.reserve_ratio = capacity_report.available_entries == 0 ? 1.0f
+        : static_cast<float>(capacity_report.reserve_entries) / capacity_report.available_entries;
+    if (report) {
+        *report = capacity_report;
+    }
+    if (capacity_report.required_entries + capacity_report.reserve_entries > capacity_report.available_entries) {
+        MYNVS_LOGW(TAG, "空间不足: 需要%u(+%u)个条目，可用%u个条目", static_cast<unsigned>(capacity_report.required_entries),
+            static_cast<unsigned>(capacity_report.reserve_entries), static_cast<unsigned>(capacity_report.available_entries));
+        return ESP_ERR_NVS_NOT_ENOUGH_SPACE;
+    }
+    return ESP_OK;
+}
+
+// --- 快照模式 ---
+esp_err_t MyNVS::enable_snapshot()
+{
+    std::unique_lock<std::mutex> lock;
+    auto err = lock_slot(lock, false);
+    if (err != ESP_OK) {
+        return err;
+    }
+    std::shared_ptr<const MyNVS_Snapshot> snapshot;
+    err = MyNVS_Snapshot::load(m_nvs->handle, snapshot);
+    if (err == ESP_OK) {
+        m_nvs->snapshot_enabled = true;
+        publish_snapshot(m_nvs, std::move(snapshot));
+    }
+    return err;
+}
+
+esp_err_t MyNVS::disable_snapshot()
+{
+    std::unique_lock<std::mutex> lock;
+    auto err = lock_slot(lock, false);
+    if (err != ESP_OK) {
+        return err;
+    }
+    m_nvs->snapshot_enabled = false;
+    publish_snapshot(m_nvs, nullptr);
+    return ESP_OK;
+}
+
+std::shared_ptr<const MyNVS_Snapshot> MyNVS::snapshot() const
+{
+    if (!m_nvs) {
+        return nullptr;
+    }
+    return m_nvs->snapshot.load(std::memory_order_acquire);
+}
+
+uint32_t MyNVS::snapshot_version() const
+{
+    return m_nvs ? m_nvs->snapshot_version.load(std::memory_order_acquire) : 0;
+}
+
+// --- 变更订阅 ---
+int MyNVS::watch(const char* prefix, my_nvs_watch_cb_t callback)
+{
+    if (!m_nvs) {
+        MYNVS_LOGE(TAG, "NVS未正确打开或实例已失效");
+        return INVALID_WATCH_ID;
+    }
+    return m_manager->watch(m_nvs->partition.c_str(), m_nvs->name_space.c_str(), prefix, std::move(callback));
+}
+
+int MyNVS::watch(const char* prefix, QueueHandle_t queue)
+{
+    if (!m_nvs) {
+        MYNVS_LOGE(TAG, "NVS未正确打开或实例已失效");
+        return INVALID_WATCH_ID;
+    }
+    return m_manager->watch(m_nvs->partition.c_str(), m_nvs->name_space.c_str(), prefix, queue);
+}
+
+void MyNVS::unwatch(int id)
+{
+    m_manager->unwatch(id);
+}
+
+void MyNVS::begin_batch()
+{
+    std::lock_guard<std::mutex> lock(m_batch_mutex);
+    m_batch_depth++;
+}
+
+void MyNVS::end_batch()
+{
+    std::vector<my_nvs_event_t> pending;
+    {
+        std::lock_guard<std::mutex> lock(m_batch_mutex);
+        if (m_batch_depth == 0 || --m_batch_depth > 0) {
+            return;
+        }
+        pending.swap(m_pending);
+    }
+    for (auto &event : pending) {
+        m_manager->notify(event);
+    }
+}
+
+void MyNVS::notify(my_nvs_event_type_t type, const char* key)
+{
+    if (!m_nvs || !m_manager->has_watchers()) {
+        return;
+    }
+    {
+        std::lock_guard<std::mutex> lock(m_batch_mutex);
+        if (m_batch_depth > 0) {
+            merge_event(m_pending, MyNVS_Manager::make_event(m_nvs, type, key));
+            return;
+        }
+    }
+    m_manager->notify(m_nvs, type, key);
+}
+
+void MyNVS::notify_events(std::vector<my_nvs_event_t>& events)
+{
+    {
+        std::lock_guard<std::mutex> lock(m_batch_mutex);
+        if (m_batch_depth > 0) {
+            for (auto &event : events) {
+                merge_event(m_pending, event);
+            }
+            return;
+        }
+    }
+    for (auto &event : events) {
+        m_manager->notify(event);
     }
-    return nvs_commit(m_nvs->handle);
 }
\ No newline at end of file
@@ -0,0 +1,197 @@
+/*
+ *             Copyright [2025] [samllin]
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *        http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+
+#include <string.h>
+#include <algorithm>
+#include "esp_log.h"
+#include "my_nvs_log.hpp"
+#include "my_nvs.hpp"
+#include "my_nvs_arena.hpp"
+
+#define TAG "MyNVS_Arena"
+
+MyNVS_Arena::MyNVS_Arena(void* buffer, size_t size)
+    : m_buffer(static_cast<uint8_t*>(buffer)), m_size(buffer ? size : 0), m_upstream(nullptr)
+{
+}
+
+MyNVS_Arena::MyNVS_Arena(size_t size, std::pmr::memory_resource* upstream)
+    : m_buffer(static_cast<uint8_t*>(upstream->allocate(size, alignof(std::max_align_t)))), m_size(size), m_upstream(upstream)
+{
+}
+
+MyNVS_Arena::~MyNVS_Arena()
+{
+    if (m_upstream) {
+        m_upstream->deallocate(m_buffer, m_size, alignof(std::max_align_t));
+    }
+}
+
+size_t MyNVS_Arena::required(size_t bytes, size_t alignment) const
+{
+    auto address = reinterpret_cast<uintptr_t>(m_buffer) + m_used;
+    return ((alignment - address % alignment) % alignment) + bytes;
+}
+
+void* MyNVS_Arena::do_allocate(size_t bytes, size_t alignment)
+{
+    size_t length = required(bytes, alignment);
+    if (length > remaining()) {
+        MYNVS_LOGE(TAG, "内存池不足: 需要%u 剩余%u", static_cast<unsigned>(length), static_cast<unsigned>(remaining()));
+        return std::pmr::null_memory_resource()->allocate(bytes, alignment);
+    }
+    void* ptr = m_buffer + m_used + (length - bytes);
+    m_used += length;
+    if (m_used > m_high_water) {
+        m_high_water = m_used;
+    }
+    return ptr;
+}
+
+// --- 单个字符串读取 ---
+esp_err_t MyNVS::read(const char* key, std::pmr::string& value, MyNVS_Arena& arena)
+{
+    if (value.get_allocator().resource() != &arena) {
+        MYNVS_LOGE(TAG, "读取%s失败: 字符串未使用该内存池", key ? key : "");
+        return ESP_ERR_INVALID_ARG;
+    }
+    // 在槽位锁内由长度回调检查容量，容量不足时返回nullptr，不触发null_memory_resource的abort
+    return read_str(key, [](void* ctx, size_t length) -> void* {
+        auto& str = *static_cast<std::pmr::string*>(ctx);
+        auto& pool = *static_cast<MyNVS_Arena*>(str.get_allocator().resource());
+        size_t size = length > 0 ? length - 1 : 0;
+        if (size > str.capacity()) {
+            // 扩容时容量至少翻倍（含结尾'\0'），按此保守估计
+            size_t needed = pool.required(std::max(size, 2 * str.capacity()) + 1, alignof(char));
+            if (needed > pool.remaining()) {
+                MYNVS_LOGE(TAG, "内存池不足: 需要%u 剩余%u", static_cast<unsigned>(needed), static_cast<unsigned>(pool.remaining()));
+                return nullptr;
+            }
+        }
+        str.resize(size);
+        return str.data();
+    }, &value);
+}
+
+// --- 批量加载 ---
+// 遍历名字空间中类型为type、键名以prefix开头的条目，visitor返回非ESP_OK时停止
+template <typename Visitor>
+static esp_err_t visit_prefix(nvs_handle_t handle, nvs_type_t type, const char* prefix, Visitor&& visitor)
+{
+    size_t prefix_length = strlen(prefix);
+    nvs_iterator_t it = nullptr;
+    auto err = nvs_entry_find_in_handle(handle, type, &it);
+    while (err == ESP_OK) {
+        nvs_entry_info_t info;
+        nvs_entry_info(it, &info);
+        if (strncmp(info.key, prefix, prefix_length) == 0) {
+            err = visitor(info.key);
+            if (err != ESP_OK) {
+                break;
+            }
+        }
+        err = nvs_entry_next(&it);
+    }
+    nvs_release_iterator(it);
+    return err == ESP_ERR_NVS_NOT_FOUND ? ESP_OK : err;
+}
+
+static esp_err_t get_length(nvs_handle_t handle, nvs_type_t type, const char* key, size_t* length)
+{
+    *length = 0;
+    if (type == NVS_TYPE_STR) {
+        auto err = nvs_get_str(handle, key, nullptr, length);
+        if (err == ESP_OK && *length > 0) {
+            (*length)--;
+        }
+        return err;
+    }
+    return nvs_get_blob(handle, key, nullptr, length);
+}
+
+esp_err_t MyNVS::load_values(const char* prefix, nvs_type_t type, MyNVS_Arena& arena, std::pmr::vector<my_nvs_arena_value_t>& out)
+{
+    if (prefix == nullptr) {
+        prefix = "";
+    }
+    std::unique_lock<std::mutex> lock;
+    auto err = lock_slot(lock, false);
+    if (err != ESP_OK) {
+        return err;
+    }
+    auto handle = m_nvs->handle;
+
+    // 第一遍：统计条目数及键名、值所需字节数（均按1字节对齐，含结尾'\0'）
+    size_t count = 0;
+    size_t bytes = 0;
+    err = visit_prefix(handle, type, prefix, [&](const char* key) {
+        size_t length = 0;
+        auto result = get_length(handle, type, key, &length);
+        count++;
+        bytes += strlen(key) + 1 + length + 1;
+        return result;
+    });
+    if (err != ESP_OK) {
+        MYNVS_LOGE(TAG, "统计名字空间%s失败: %s", m_nvs->name_space.c_str(), esp_err_to_name(err));
+        return err;
+    }
+    size_t needed = bytes;
+    size_t total = out.size() + count;
+    if (out.get_allocator().resource() == &arena && out.capacity() < total) {
+        needed += arena.required(total * sizeof(my_nvs_arena_value_t), alignof(my_nvs_arena_value_t));
+    }
+    if (needed > arena.remaining()) {
+        MYNVS_LOGE(TAG, "内存池不足: 加载%u个键需要%u字节，剩余%u", static_cast<unsigned>(count),
+            static_cast<unsigned>(needed), static_cast<unsigned>(arena.remaining()));
+        return ESP_ERR_NO_MEM;
+    }
+    out.reserve(total);
+
+    // 第二遍：在同一把锁内读取，键集合不会变化
+    return visit_prefix(handle, type, prefix, [&](const char* key) {
+        size_t key_length = strlen(key) + 1;
+        size_t length = 0;
+        auto result = get_length(handle, type, key, &length);
+        if (result != ESP_OK) {
+            return result;
+        }
+        auto key_copy = static_cast<char*>(arena.allocate(key_length, 1));
+        auto data = static_cast<char*>(arena.allocate(length + 1, 1));
+        memcpy(key_copy, key, key_length);
+        size_t size = length + 1;
+        if (type == NVS_TYPE_STR) {
+            result = nvs_get_str(handle, key, data, &size);
+        } else {
+            size = length;
+            result = length == 0 ? ESP_OK : nvs_get_blob(handle, key, data, &size);
+            data[length] = '\0';
+        }
+        if (result == ESP_OK) {
+            out.push_back({key_copy, data, length});
+        }
+        return result;
+    });
+}
+
+esp_err_t MyNVS::load_strings(const char* prefix, MyNVS_Arena& arena, std::pmr::vector<my_nvs_arena_value_t>& out)
+{
+    return load_values(prefix, NVS_TYPE_STR, arena, out);
+}
+
+esp_err_t MyNVS::load_blobs(const char* prefix, MyNVS_Arena& arena, std::pmr::vector<my_nvs_arena_value_t>& out)
+{
+    return load_values(prefix, NVS_TYPE_BLOB, arena, out);
+}
@@ -0,0 +1,188 @@
+/*
+ *             Copyright [2025] [samllin]
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *        http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+
+#include <stddef.h>
+#include <stdio.h>
+#include <string.h>
+#include "esp_log.h"
+#include "my_nvs_log.hpp"
+#include "esp_rom_crc.h"
+#include "my_nvs_dual_record.hpp"
+
+#define TAG "MyNVS_DualRecord"
+
+#define DUAL_RECORD_MAGIC   0x4D4E4452  // "RDNM"
+
+MyNVS_DualRecordBase::MyNVS_DualRecordBase(MyNVS& nvs, const char* name)
+    : m_nvs(nvs)
+{
+    char safe_name[DUAL_RECORD_NAME_LENGTH + 1];
+    if (name == nullptr) {
+        name = "";
+    }
+    if (strlen(name) > DUAL_RECORD_NAME_LENGTH) {
+        strncpy(safe_name, name, DUAL_RECORD_NAME_LENGTH);
+        safe_name[DUAL_RECORD_NAME_LENGTH] = '\0';
+        MYNVS_LOGW(TAG, "record name is too loog, original name=%s name=%s, may be cause error!", name, safe_name);
+        name = safe_name;
+    }
+    snprintf(m_keys[0], sizeof(m_keys[0]), "%s.a", name);
+    snprintf(m_keys[1], sizeof(m_keys[1]), "%s.b", name);
+    snprintf(m_pointer_key, sizeof(m_pointer_key), "%s.p", name);
+}
+
+uint32_t MyNVS_DualRecordBase::crc_of(const header_t& header, const void* value, size_t length)
+{
+    auto crc = esp_rom_crc32_le(0, reinterpret_cast<const uint8_t*>(&header), offsetof(header_t, crc));
+    return esp_rom_crc32_le(crc, static_cast<const uint8_t*>(value), length);
+}
+
+esp_err_t MyNVS_DualRecordBase::read_copy(int index, size_t length, uint8_t* buffer, uint32_t* generation)
+{
+    size_t expected = sizeof(header_t) + length;
+    size_t size = expected;
+    auto err = m_nvs.read(m_keys[index], buffer, &size);
+    if (err == ESP_ERR_NVS_INVALID_LENGTH) {
+        return ESP_ERR_INVALID_SIZE;
+    }
+    if (err != ESP_OK) {
+        return err;
+    }
+    header_t header;
+    memcpy(&header, buffer, sizeof(header));
+    if (size != expected || header.magic != DUAL_RECORD_MAGIC || header.length != length) {
+        return ESP_ERR_INVALID_SIZE;
+    }
+    if (header.crc != crc_of(header, buffer + sizeof(header_t), length)) {
+        return ESP_ERR_INVALID_CRC;
+    }
+    *generation = header.generation;
+    return ESP_OK;
+}
+
+static esp_err_t both_failed(esp_err_t first, esp_err_t second)
+{
+    return (first == ESP_ERR_NVS_NOT_FOUND && second == ESP_ERR_NVS_NOT_FOUND) ? ESP_ERR_NVS_NOT_FOUND : ESP_ERR_INVALID_CRC;
+}
+
+esp_err_t MyNVS_DualRecordBase::select_copy(size_t length, uint8_t* buffer, int* index, uint32_t* generation)
+{
+    uint8_t pointer = 0;
+    auto err = m_nvs.read(m_pointer_key, pointer);
+    if (err != ESP_OK && err != ESP_ERR_NVS_NOT_FOUND && err != ESP_ERR_NVS_TYPE_MISMATCH) {
+        return err;
+    }
+
+    if (err == ESP_OK && pointer <= 1) {
+        // 只校验活动副本，失败时才检查另一副本
+        auto active_err = read_copy(pointer, length, buffer, generation);
+        if (active_err == ESP_OK) {
+            *index = pointer;
+            return ESP_OK;
+        }
+        err = read_copy(1 - pointer, length, buffer, generation);
+        if (err != ESP_OK) {
+            return both_failed(active_err, err);
+        }
+        MYNVS_LOGW(TAG, "%s无效(%s)，回退到%s", m_keys[pointer], esp_err_to_name(active_err), m_keys[1 - pointer]);
+        *index = 1 - pointer;
+        return ESP_OK;
+    }
+
+    // 指针不存在或已损坏：校验两份副本，均有效时取代数较新的一份（按差值比较，容忍回绕）
+    uint32_t generations[2] = {0, 0};
+    auto err_a = read_copy(0, length, buffer, &generations[0]);
+    auto err_b = read_copy(1, length, buffer, &generations[1]);
+    if (err_a != ESP_OK && err_b != ESP_OK) {
+        return both_failed(err_a, err_b);
+    }
+    int chosen = (err_b == ESP_OK && (err_a != ESP_OK || static_cast<int32_t>(generations[1] - generations[0]) > 0)) ? 1 : 0;
+    if (chosen == 0) {
+        // 缓冲区中是后读取的B，重新读取A
+        err = read_copy(0, length, buffer, &generations[0]);
+        if (err != ESP_OK) {
+            return err;
+        }
+    }
+    MYNVS_LOGW(TAG, "%s不存在或无效，按代数选择%s", m_pointer_key, m_keys[chosen]);
+    *index = chosen;
+    *generation = generations[chosen];
+    return ESP_OK;
+}
+
+esp_err_t MyNVS_DualRecordBase::load(void* value, size_t length, uint8_t* buffer)
+{
+    if (value == nullptr) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    int index = -1;
+    uint32_t generation = 0;
+    auto err = select_copy(length, buffer, &index, &generation);
+    if (err != ESP_OK) {
+        if (err == ESP_ERR_NVS_NOT_FOUND || err == ESP_ERR_INVALID_CRC) {
+            m_active = -1;
+            m_generation = 0;
+        }
+        return err;
+    }
+    memcpy(value, buffer + sizeof(header_t), length);
+    m_active = index;
+    m_generation = generation;
+    return ESP_OK;
+}
+
+esp_err_t MyNVS_DualRecordBase::store(const void* value, size_t length, uint8_t* buffer)
+{
+    if (value == nullptr) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    if (m_active < 0) {
+        // 尚未加载：先确定活动副本及其代数，不存在或均损坏时从A开始
+        int index = -1;
+        uint32_t generation = 0;
+        auto err = select_copy(length, buffer, &index, &generation);
+        if (err == ESP_OK) {
+            m_active = index;
+            m_generation = generation;
+        } else if (err != ESP_ERR_NVS_NOT_FOUND && err != ESP_ERR_INVALID_CRC) {
+            return err;
+        }
+    }
+    int target = (m_active < 0) ? 0 : 1 - m_active;
+    header_t header = {DUAL_RECORD_MAGIC, m_generation + 1, static_cast<uint32_t>(length), 0};
+    header.crc = crc_of(header, value, length);
+    memcpy(buffer, &header, sizeof(header));
+    memcpy(buffer + sizeof(header), value, length);
+
+    // 先写非活动副本并提交，再切换指针
+    auto err = m_nvs.write(m_keys[target], buffer, sizeof(header_t) + length);
+    if (err == ESP_OK) {
+        err = m_nvs.commit();
+    }
+    if (err == ESP_OK) {
+        err = m_nvs.write(m_pointer_key, static_cast<uint8_t>(target));
+    }
+    if (err == ESP_OK) {
+        err = m_nvs.commit();
+    }
+    if (err != ESP_OK) {
+        MYNVS_LOGE(TAG, "写入%s失败: %s", m_keys[target], esp_err_to_name(err));
+        return err;
+    }
+    m_active = target;
+    m_generation = header.generation;
+    return ESP_OK;
+}
\ No newline at end of file
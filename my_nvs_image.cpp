@@ -0,0 +1,249 @@
+/*
+ *             Copyright [2025] [samllin]
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *        http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+
+#include <stddef.h>
+#include <string.h>
+#include <set>
+#include <string>
+#include "esp_log.h"
+#include "my_nvs_log.hpp"
+#include "esp_rom_crc.h"
+#include "my_nvs.hpp"
+#include "my_nvs_image.hpp"
+#include "my_nvs_planner.hpp"
+#include "my_nvs_snapshot.hpp"
+#include "my_nvs_warm_cache.hpp"
+
+#define TAG "MyNVS_Image"
+
+// 镜像中的一个条目，指向镜像内存
+struct image_entry_t {
+    nvs_type_t      type;
+    char            key[NVS_KEY_NAME_MAX_SIZE];
+    const uint8_t*  value;
+    uint32_t        length;
+};
+
+static void append(std::vector<uint8_t>& out, const void* data, size_t length)
+{
+    auto bytes = static_cast<const uint8_t*>(data);
+    out.insert(out.end(), bytes, bytes + length);
+}
+
+// CRC覆盖头部crc之前的字段及全部条目，头部被改写同样无法通过校验
+static uint32_t image_crc(const my_nvs_image_header_t& header, const uint8_t* payload)
+{
+    auto crc = esp_rom_crc32_le(0, reinterpret_cast<const uint8_t*>(&header), offsetof(my_nvs_image_header_t, crc));
+    return esp_rom_crc32_le(crc, payload, header.payload_length);
+}
+
+static bool valid_entry(nvs_type_t type, const uint8_t* value, uint32_t length)
+{
+    size_t width = nvs_integer_size(type);
+    if (width != 0) {
+        return length == width;
+    } else if (type == NVS_TYPE_STR) {
+        return length > 0 && value[length - 1] == '\0';
+    }
+    return type == NVS_TYPE_BLOB;
+}
+
+// 校验并解析镜像，不访问Flash
+static esp_err_t parse_image(const uint8_t* image, size_t length, std::vector<image_entry_t>& entries)
+{
+    my_nvs_image_header_t header;
+    if (image == nullptr || length < sizeof(header)) {
+        return ESP_ERR_INVALID_SIZE;
+    }
+    memcpy(&header, image, sizeof(header));
+    if (header.magic != MY_NVS_IMAGE_MAGIC) {
+        MYNVS_LOGE(TAG, "镜像标识错误: 0x%08x", static_cast<unsigned>(header.magic));
+        return ESP_ERR_INVALID_ARG;
+    }
+    if (header.version != MY_NVS_IMAGE_VERSION) {
+        MYNVS_LOGE(TAG, "不支持的镜像版本: %u", header.version);
+        return ESP_ERR_INVALID_VERSION;
+    }
+    if (header.payload_length != length - sizeof(header)) {
+        MYNVS_LOGE(TAG, "镜像长度不匹配: %u/%u", static_cast<unsigned>(header.payload_length), static_cast<unsigned>(length - sizeof(header)));
+        return ESP_ERR_INVALID_SIZE;
+    }
+    const uint8_t* payload = image + sizeof(header);
+    if (image_crc(header, payload) != header.crc) {
+        MYNVS_LOGE(TAG, "镜像CRC校验失败");
+        return ESP_ERR_INVALID_CRC;
+    }
+
+    size_t offset = 0;
+    entries.clear();
+    entries.reserve(header.count);
+    for (uint16_t i = 0; i < header.count; i++) {
+        image_entry_t entry = {};
+        if (offset + 2 > header.payload_length) {
+            return ESP_ERR_INVALID_SIZE;
+        }
+        entry.type = static_cast<nvs_type_t>(payload[offset]);
+        uint8_t key_length = payload[offset + 1];
+        offset += 2;
+        if (key_length == 0 || key_length >= NVS_KEY_NAME_MAX_SIZE || offset + key_length + 4 > header.payload_length) {
+            return ESP_ERR_INVALID_SIZE;
+        }
+        memcpy(entry.key, payload + offset, key_length);
+        offset += key_length;
+        memcpy(&entry.length, payload + offset, sizeof(entry.length));
+        offset += sizeof(entry.length);
+        if (offset + entry.length > header.payload_length) {
+            return ESP_ERR_INVALID_SIZE;
+        }
+        entry.value = payload + offset;
+        offset += entry.length;
+        if (!valid_entry(entry.type, entry.value, entry.length)) {
+            MYNVS_LOGE(TAG, "镜像条目%s非法: 类型0x%02x 长度%u", entry.key, entry.type, static_cast<unsigned>(entry.length));
+            return ESP_ERR_INVALID_ARG;
+        }
+        entries.push_back(entry);
+    }
+    return offset == header.payload_length ? ESP_OK : ESP_ERR_INVALID_SIZE;
+}
+
+esp_err_t MyNVS::export_namespace(std::vector<uint8_t>& image)
+{
+    std::shared_ptr<const MyNVS_Snapshot> snapshot;
+    {
+        std::unique_lock<std::mutex> lock;
+        auto err = lock_slot(lock, false);
+        if (err != ESP_OK) {
+            return err;
+        }
+        err = MyNVS_Snapshot::load(m_nvs->handle, snapshot);
+        if (err != ESP_OK) {
+            return err;
+        }
+    }
+    if (snapshot->size() > UINT16_MAX) {
+        return ESP_ERR_INVALID_SIZE;
+    }
+
+    my_nvs_image_header_t header = {MY_NVS_IMAGE_MAGIC, MY_NVS_IMAGE_VERSION, static_cast<uint16_t>(snapshot->size()), 0, 0};
+    image.assign(sizeof(header), 0);
+    snapshot->for_each([&image](const char* key, nvs_type_t type, const void* data, size_t length) {
+        uint8_t prefix[2] = {static_cast<uint8_t>(type), static_cast<uint8_t>(strlen(key))};
+        uint32_t value_length = static_cast<uint32_t>(length);
+        append(image, prefix, sizeof(prefix));
+        append(image, key, prefix[1]);
+        append(image, &value_length, sizeof(value_length));
+        append(image, data, length);
+    });
+    header.payload_length = static_cast<uint32_t>(image.size() - sizeof(header));
+    header.crc = image_crc(header, image.data() + sizeof(header));
+    memcpy(image.data(), &header, sizeof(header));
+    return ESP_OK;
+}
+
+esp_err_t MyNVS::import_namespace(const void* image, size_t length, bool erase_first)
+{
+    // 写入Flash前完成全部校验及空间预检
+    std::vector<image_entry_t> entries;
+    auto err = parse_image(static_cast<const uint8_t*>(image), length, entries);
+    if (err != ESP_OK) {
+        return err;
+    }
+    MyNVS_Planner plan;
+    for (auto &entry : entries) {
+        if (entry.type == NVS_TYPE_STR) {
+            plan.add_string(entry.length - 1);
+        } else if (entry.type == NVS_TYPE_BLOB) {
+            plan.add_blob(entry.length);
+        } else {
+            plan.add_items();
+        }
+    }
+    // 先清空时名字空间现有条目可被回收，预检通过前不执行nvs_erase_all
+    err = can_fit(plan, nullptr, erase_first);
+    if (err != ESP_OK) {
+        return err;
+    }
+
+    {
+        std::unique_lock<std::mutex> lock;
+        err = lock_slot(lock, true);
+        if (err != ESP_OK) {
+            return err;
+        }
+        // 保留导入前的名字空间内容，写入中途失败时据此恢复
+        std::shared_ptr<const MyNVS_Snapshot> before;
+        err = MyNVS_Snapshot::load(m_nvs->handle, before);
+        if (err != ESP_OK) {
+            return err;
+        }
+#if CONFIG_MYNVS_WARM_CACHE
+        MyNVS_WarmCache::invalidate_namespace(m_nvs->cache_id);
+#endif
+        if (erase_first) {
+            err = nvs_erase_all(m_nvs->handle);
+        }
+        size_t written = 0;
+        for (; written < entries.size() && err == ESP_OK; written++) {
+            err = set_value(m_nvs->handle, entries[written].key, entries[written].type, entries[written].value, entries[written].length);
+            if (err != ESP_OK) {
+                MYNVS_LOGE(TAG, "导入%s失败: %s", entries[written].key, esp_err_to_name(err));
+            }
+        }
+        if (err == ESP_OK) {
+            err = nvs_commit(m_nvs->handle);
+        }
+        if (err != ESP_OK) {
+            // 恢复导入前的内容：先清空（或删除已尝试写入的键），再写回原有条目
+            std::set<std::string> touched;
+            esp_err_t undo_err = ESP_OK;
+            if (erase_first) {
+                undo_err = nvs_erase_all(m_nvs->handle);
+            } else {
+                for (size_t i = 0; i < written; i++) {
+                    touched.insert(entries[i].key);
+                    auto erase_err = nvs_erase_key(m_nvs->handle, entries[i].key);
+                    undo_err = (erase_err == ESP_OK || erase_err == ESP_ERR_NVS_NOT_FOUND) ? undo_err : erase_err;
+                }
+            }
+            before->for_each([&](const char* key, nvs_type_t type, const void* data, size_t length) {
+                if (erase_first || touched.count(key)) {
+                    auto set_err = set_value(m_nvs->handle, key, type, data, length);
+                    undo_err = set_err == ESP_OK ? undo_err : set_err;
+                }
+            });
+            if (undo_err == ESP_OK) {
+                undo_err = nvs_commit(m_nvs->handle);
+            }
+            if (undo_err != ESP_OK) {
+                MYNVS_LOGE(TAG, "名字空间%s导入失败后恢复失败: %s", m_nvs->name_space.c_str(), esp_err_to_name(undo_err));
+            }
+            return err;
+        }
+        MYNVS_LOGI(TAG, "名字空间%s导入%u个键", m_nvs->name_space.c_str(), static_cast<unsigned>(entries.size()));
+    }
+    // 释放槽位锁后通知：先清空时发送ERASE_ALL，随后逐键发送WRITE，最后由commit刷新快照并发送COMMIT
+    if (m_manager->has_watchers()) {
+        std::vector<my_nvs_event_t> events;
+        if (erase_first) {
+            events.push_back(MyNVS_Manager::make_event(m_nvs, MY_NVS_EVENT_ERASE_ALL, nullptr));
+        }
+        for (auto &entry : entries) {
+            events.push_back(MyNVS_Manager::make_event(m_nvs, MY_NVS_EVENT_WRITE, entry.key));
+        }
+        notify_events(events);
+    }
+    return commit();
+}
\ No newline at end of file
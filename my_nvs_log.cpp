@@ -0,0 +1,76 @@
+/*
+ *             Copyright [2025] [samllin]
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *        http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+
+#include "my_nvs_log.hpp"
+
+#if CONFIG_MYNVS_ERROR_RING
+#include <atomic>
+
+// 每个槽位以seq作为发布标志：写入期间为0，写完后置为记录序号；读取前后seq一致才视为有效
+struct ring_slot_t {
+    std::atomic<uint32_t>       seq{0};
+    std::atomic<const char*>    tag{nullptr};
+    std::atomic<uint16_t>       line{0};
+    std::atomic<char>           level{0};
+};
+
+static ring_slot_t s_ring[CONFIG_MYNVS_ERROR_RING_SIZE];
+static std::atomic<uint32_t> s_head{0};     // 已分配的记录数
+
+void MyNVS_ErrorRing::push(const char* tag, uint16_t line, char level)
+{
+    uint32_t seq = s_head.fetch_add(1, std::memory_order_relaxed) + 1;
+    auto &slot = s_ring[(seq - 1) % CONFIG_MYNVS_ERROR_RING_SIZE];
+    slot.seq.store(0, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+    slot.tag.store(tag, std::memory_order_relaxed);
+    slot.line.store(line, std::memory_order_relaxed);
+    slot.level.store(level, std::memory_order_relaxed);
+    slot.seq.store(seq, std::memory_order_release);
+}
+
+size_t MyNVS_ErrorRing::read(my_nvs_error_t* out, size_t max, uint32_t* dropped)
+{
+    uint32_t head = s_head.load(std::memory_order_acquire);
+    uint32_t first = head > CONFIG_MYNVS_ERROR_RING_SIZE ? head - CONFIG_MYNVS_ERROR_RING_SIZE : 0;
+    if (dropped) {
+        *dropped = first;
+    }
+    size_t count = 0;
+    for (uint32_t seq = first + 1; seq <= head && count < max; seq++) {
+        auto &slot = s_ring[(seq - 1) % CONFIG_MYNVS_ERROR_RING_SIZE];
+        if (slot.seq.load(std::memory_order_acquire) != seq) {
+            continue;   // 正在写入或已被覆盖
+        }
+        my_nvs_error_t record = {slot.tag.load(std::memory_order_relaxed), slot.line.load(std::memory_order_relaxed),
+            slot.level.load(std::memory_order_relaxed), seq};
+        std::atomic_thread_fence(std::memory_order_acquire);
+        if (slot.seq.load(std::memory_order_relaxed) == seq) {
+            out[count++] = record;
+        }
+    }
+    return count;
+}
+
+void MyNVS_ErrorRing::clear()
+{
+    for (auto &slot : s_ring) {
+        slot.seq.store(0, std::memory_order_relaxed);
+    }
+    s_head.store(0, std::memory_order_release);
+}
+
+#endif
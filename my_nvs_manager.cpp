@@ -14,9 +14,13 @@
  *
 */
 
+#include <stdio.h>
 #include <string.h>
 #include "esp_log.h"
+#include "my_nvs_log.hpp"
 #include "my_nvs_manager.hpp"
+#include "my_nvs_snapshot.hpp"
+#include "my_nvs_warm_cache.hpp"
 
 #define TAG "MyNVS_Manager"
 
@@ -29,20 +33,27 @@ MyNVS_Manager* MyNVS_Manager::get_instance()
     std::lock_guard<std::mutex> lock(m_instance_mutex);
     if (m_nvs_manager == nullptr) {
         if (m_init_flag == false) {
+            bool erased = false;
             auto err = nvs_flash_init();
 #if defined(CONFIG_ERASE_ON_NO_FREE_PAGES) || defined(CONFIG_ERASE_ON_NEW_VERSION_FOUND)
             if (err == ESP_ERR_NVS_NO_FREE_PAGES || err == ESP_ERR_NVS_NEW_VERSION_FOUND) {
                 ESP_ERROR_CHECK(nvs_flash_erase());
-                ESP_LOGW(TAG, "由于%s,擦除NVS分区成功", esp_err_to_name(err));
+                MYNVS_LOGW(TAG, "由于%s,擦除NVS分区成功", esp_err_to_name(err));
                 err = nvs_flash_init();
+                erased = true;
             }
 #endif
             ESP_ERROR_CHECK(err);
             if (err != ESP_OK) {
-                ESP_LOGE(TAG, "NVS初始化失败，错误码：%s", esp_err_to_name(err));
+                MYNVS_LOGE(TAG, "NVS初始化失败，错误码：%s", esp_err_to_name(err));
                 return nullptr;
             }
             m_init_flag = true;
+#if CONFIG_MYNVS_WARM_CACHE
+            MyNVS_WarmCache::init(erased);
+#else
+            (void)erased;
+#endif
         }
         m_nvs_manager = new MyNVS_Manager;
         ESP_LOGI(TAG, "NVS 初始化完成.");
@@ -67,7 +78,22 @@ MyNVS_Manager::MyNVS_Manager()
         slot.open_mode = NVS_READONLY;
         slot.handle = 0;
         slot.ref = 0;
+        slot.snapshot.store(nullptr);
+        slot.snapshot_enabled = false;
+    }
+}
+
+// 关闭前提交，与MyNVS::commit相同，成功后保存有修改的名字空间的热缓存代数
+static void commit_slot(my_nvs_t& slot)
+{
+    auto err = nvs_commit(slot.handle);
+#if CONFIG_MYNVS_WARM_CACHE
+    if (err == ESP_OK && slot.open_mode == NVS_READWRITE) {
+        MyNVS_WarmCache::commit(slot.cache_id, slot.partition.c_str(), slot.name_space.c_str());
     }
+#else
+    (void)err;
+#endif
 }
 
 MyNVS_Manager::~MyNVS_Manager()
@@ -76,11 +102,13 @@ MyNVS_Manager::~MyNVS_Manager()
     for (auto &slot : m_nvs) {
         std::lock_guard<std::mutex> lock_nvs(slot.mutex);
         if (!slot.partition.empty()) {
-            nvs_commit(slot.handle);
+            commit_slot(slot);
             nvs_close(slot.handle);
             slot.partition.clear();
             slot.name_space.clear();
             slot.handle = 0;
+            slot.snapshot.store(nullptr);
+            slot.snapshot_enabled = false;
         }
     }
     m_nvs_manager = nullptr;
@@ -104,7 +132,7 @@ int8_t MyNVS_Manager::open(const char* partition, const char* name_space, nvs_op
                 slot.ref.fetch_add(1);
                 return i;
             } else {
-                ESP_LOGE(TAG, "打开[分区:名字空间:模式]=[%s:%s:%s]失败，不再支持自动升级操作模式", partition, name_space, mode == NVS_READONLY ? "NVS_READONLY" : "NVS_READWRITE");
+                MYNVS_LOGE(TAG, "打开[分区:名字空间:模式]=[%s:%s:%s]失败，不再支持自动升级操作模式", partition, name_space, mode == NVS_READONLY ? "NVS_READONLY" : "NVS_READWRITE");
                 return INVALID_INDEX;
             }
         }
@@ -118,14 +146,17 @@ int8_t MyNVS_Manager::open(const char* partition, const char* name_space, nvs_op
                 slot.name_space = name_space;
                 slot.open_mode = mode;
                 slot.ref.store(1);
+#if CONFIG_MYNVS_WARM_CACHE
+                slot.cache_id = MyNVS_WarmCache::attach(partition, name_space);
+#endif
                 return i;
             } else {
-                ESP_LOGE(TAG, "打开[分区:命名空间]:[%s:%s]失败，错误码：%s.", partition, name_space, esp_err_to_name(err));
+                MYNVS_LOGE(TAG, "打开[分区:命名空间]:[%s:%s]失败，错误码：%s.", partition, name_space, esp_err_to_name(err));
                 return INVALID_INDEX;
             }
         }
     }
-    ESP_LOGE(TAG, "槽位已满，请修改编译选项：MAX_NAMESPACE.");
+    MYNVS_LOGE(TAG, "槽位已满，请修改编译选项：MAX_NAMESPACE.");
     return INVALID_INDEX;
 }
 
@@ -137,20 +168,23 @@ int8_t MyNVS_Manager::open(const char* name_space, nvs_open_mode_t mode)
 void MyNVS_Manager::close(int8_t index)
 {
     if (index < 0 || index >= CONFIG_MAX_NAMESPACE) {
-        ESP_LOGE(TAG, "非法索引值，忽略关闭操作");
+        MYNVS_LOGE(TAG, "非法索引值，忽略关闭操作");
         return;
     }
     auto &slot = m_nvs[index];
     std::lock_guard<std::mutex> lock_manager(m_mutex);
     std::lock_guard<std::mutex> lock(slot.mutex);
     if (slot.ref.fetch_sub(1) == 1) {
-        nvs_commit(slot.handle);
+        commit_slot(slot);
         nvs_close(slot.handle);
         slot.partition.clear();
         slot.name_space.clear();
         slot.open_mode = NVS_READONLY;
         slot.handle = 0;
         slot.ref = 0;
+        slot.snapshot.store(nullptr);
+        slot.snapshot_version.fetch_add(1);
+        slot.snapshot_enabled = false;
     }
 }
 
@@ -161,3 +195,94 @@ void MyNVS_Manager::close(my_nvs_t* my_nvs)
     }
     close(static_cast<int8_t>(my_nvs - m_nvs));
 }
+
+
+int MyNVS_Manager::add_watcher(watcher_t&& watcher)
+{
+    std::lock_guard<std::mutex> lock(m_watch_mutex);
+    watcher.id = m_next_watch_id++;
+    m_watchers.push_back(std::move(watcher));
+    m_watch_count.store(static_cast<int>(m_watchers.size()), std::memory_order_relaxed);
+    return m_watchers.back().id;
+}
+
+int MyNVS_Manager::watch(const char* partition, const char* name_space, const char* prefix, my_nvs_watch_cb_t callback)
+{
+    if (partition == nullptr || name_space == nullptr || !callback) {
+        MYNVS_LOGE(TAG, "订阅参数非法");
+        return INVALID_WATCH_ID;
+    }
+    return add_watcher({INVALID_WATCH_ID, partition, name_space, prefix ? prefix : "", std::move(callback), nullptr});
+}
+
+int MyNVS_Manager::watch(const char* partition, const char* name_space, const char* prefix, QueueHandle_t queue)
+{
+    if (partition == nullptr || name_space == nullptr || queue == nullptr) {
+        MYNVS_LOGE(TAG, "订阅参数非法");
+        return INVALID_WATCH_ID;
+    }
+    return add_watcher({INVALID_WATCH_ID, partition, name_space, prefix ? prefix : "", nullptr, queue});
+}
+
+void MyNVS_Manager::unwatch(int id)
+{
+    std::lock_guard<std::mutex> lock(m_watch_mutex);
+    for (auto it = m_watchers.begin(); it != m_watchers.end(); ++it) {
+        if (it->id == id) {
+            m_watchers.erase(it);
+            break;
+        }
+    }
+    m_watch_count.store(static_cast<int>(m_watchers.size()), std::memory_order_relaxed);
+}
+
+my_nvs_event_t MyNVS_Manager::make_event(const my_nvs_t* my_nvs, my_nvs_event_type_t type, const char* key)
+{
+    my_nvs_event_t event;
+    event.type = type;
+    snprintf(event.partition, sizeof(event.partition), "%s", my_nvs->partition.c_str());
+    snprintf(event.name_space, sizeof(event.name_space), "%s", my_nvs->name_space.c_str());
+    snprintf(event.key, sizeof(event.key), "%s", key ? key : "");
+    return event;
+}
+
+void MyNVS_Manager::notify(const my_nvs_t* my_nvs, my_nvs_event_type_t type, const char* key)
+{
+    if (my_nvs == nullptr || !has_watchers()) {
+        return;
+    }
+    notify(make_event(my_nvs, type, key));
+}
+
+void MyNVS_Manager::notify(const my_nvs_event_t& event)
+{
+    // 在订阅表锁内收集匹配项，锁外分发，回调中可安全地读写NVS或取消订阅
+    std::vector<my_nvs_watch_cb_t> callbacks;
+    std::vector<QueueHandle_t> queues;
+    {
+        std::lock_guard<std::mutex> lock(m_watch_mutex);
+        for (auto &watcher : m_watchers) {
+            if (watcher.partition != event.partition || watcher.name_space != event.name_space) {
+                continue;
+            }
+            // 名字空间级事件匹配全部订阅，键级事件按前缀匹配
+            bool key_event = (event.type == MY_NVS_EVENT_WRITE || event.type == MY_NVS_EVENT_ERASE);
+            if (key_event && strncmp(event.key, watcher.prefix.c_str(), watcher.prefix.size()) != 0) {
+                continue;
+            }
+            if (watcher.queue) {
+                queues.push_back(watcher.queue);
+            } else {
+                callbacks.push_back(watcher.callback);
+            }
+        }
+    }
+    for (auto queue : queues) {
+        if (xQueueSend(queue, &event, 0) != pdTRUE) {
+            MYNVS_LOGW(TAG, "事件队列已满，丢弃[%s:%s]的变更事件", event.name_space, event.key);
+        }
+    }
+    for (auto &callback : callbacks) {
+        callback(event);
+    }
+}
\ No newline at end of file
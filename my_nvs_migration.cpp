@@ -0,0 +1,393 @@
+/*
+ *             Copyright [2025] [samllin]
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *        http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+
+#include <string.h>
+#include "esp_log.h"
+#include "my_nvs_log.hpp"
+#include "my_nvs.hpp"
+#include "my_nvs_snapshot.hpp"
+#include "my_nvs_migration.hpp"
+#include "my_nvs_warm_cache.hpp"
+
+#define TAG "MyNVS_Migration"
+
+// 键名按NVS长度截断，与MyNVS读写时的处理一致
+static std::string key_of(const char* key)
+{
+    return std::string(key ? key : "").substr(0, KEY_LENGTH);
+}
+
+static bool is_bytes_type(nvs_type_t type)
+{
+    return type == NVS_TYPE_STR || type == NVS_TYPE_BLOB;
+}
+
+// 值的原始字节：整数为小端原始宽度，字符串去掉结尾'\0'
+static std::vector<uint8_t> bytes_of(const std::vector<uint8_t>& data, nvs_type_t type)
+{
+    if (type == NVS_TYPE_STR && !data.empty()) {
+        return std::vector<uint8_t>(data.begin(), data.end() - 1);
+    }
+    return data;
+}
+
+// 由原始字节构造目标类型的值
+static esp_err_t value_from_bytes(const uint8_t* data, size_t length, nvs_type_t type, std::vector<uint8_t>& out)
+{
+    size_t width = nvs_integer_size(type);
+    if (width != 0) {
+        if (length > width) {
+            return ESP_ERR_INVALID_SIZE;
+        }
+        out.assign(width, 0);
+        memcpy(out.data(), data, length);
+    } else if (type == NVS_TYPE_STR) {
+        out.assign(data, data + length);
+        out.push_back('\0');
+    } else if (type == NVS_TYPE_BLOB) {
+        out.assign(data, data + length);
+    } else {
+        return ESP_ERR_NOT_SUPPORTED;
+    }
+    return ESP_OK;
+}
+
+// 整数类型转换，超出目标范围时返回ESP_ERR_INVALID_SIZE
+static esp_err_t convert_integer(const std::vector<uint8_t>& data, nvs_type_t from, nvs_type_t to, std::vector<uint8_t>& out)
+{
+    size_t from_width = nvs_integer_size(from);
+    size_t to_width = nvs_integer_size(to);
+    uint64_t bits = 0;
+    memcpy(&bits, data.data(), from_width);
+    // 有符号数先符号扩展至64位
+    if (nvs_integer_signed(from) && from_width < 8 && (bits >> (from_width * 8 - 1)) & 1) {
+        bits |= ~0ULL << (from_width * 8);
+    }
+    bool negative = nvs_integer_signed(from) && static_cast<int64_t>(bits) < 0;
+
+    if (nvs_integer_signed(to)) {
+        int64_t value = static_cast<int64_t>(bits);
+        int64_t max = to_width == 8 ? INT64_MAX : (INT64_C(1) << (to_width * 8 - 1)) - 1;
+        int64_t min = -max - 1;
+        if ((!negative && bits > static_cast<uint64_t>(max)) || value < min) {
+            return ESP_ERR_INVALID_SIZE;
+        }
+    } else {
+        uint64_t max = to_width == 8 ? UINT64_MAX : (UINT64_C(1) << (to_width * 8)) - 1;
+        if (negative || bits > max) {
+            return ESP_ERR_INVALID_SIZE;
+        }
+    }
+    out.assign(to_width, 0);
+    memcpy(out.data(), &bits, to_width);
+    return ESP_OK;
+}
+
+void MyNVS_Migration::store_t::set(const std::string& key, value_t&& value)
+{
+    values[key] = std::move(value);
+    dirty.insert(key);
+    erased.erase(key);
+}
+
+void MyNVS_Migration::store_t::remove(const std::string& key)
+{
+    values.erase(key);
+    dirty.erase(key);
+    erased.insert(key);
+}
+
+MyNVS_Migration& MyNVS_Migration::version(uint32_t version)
+{
+    if (version <= latest()) {
+        MYNVS_LOGE(TAG, "版本号%u须严格递增且大于0", static_cast<unsigned>(version));
+        m_valid = false;
+        return *this;
+    }
+    m_groups.push_back({version, {}});
+    return *this;
+}
+
+MyNVS_Migration& MyNVS_Migration::add(step_t&& step)
+{
+    if (m_groups.empty()) {
+        MYNVS_LOGE(TAG, "迁移步骤须位于version()之后");
+        m_valid = false;
+        return *this;
+    }
+    m_groups.back().steps.push_back(std::move(step));
+    return *this;
+}
+
+MyNVS_Migration& MyNVS_Migration::rename(const char* from, const char* to)
+{
+    return add({op_t::RENAME, {key_of(from)}, {key_of(to)}, {}});
+}
+
+MyNVS_Migration& MyNVS_Migration::retype(const char* key, nvs_type_t type)
+{
+    return add({op_t::RETYPE, {key_of(key)}, {}, {type}});
+}
+
+MyNVS_Migration& MyNVS_Migration::split(const char* from, std::initializer_list<target_t> to)
+{
+    step_t step{op_t::SPLIT, {key_of(from)}, {}, {}};
+    for (auto &target : to) {
+        step.to.push_back(key_of(target.key));
+        step.types.push_back(target.type);
+    }
+    return add(std::move(step));
+}
+
+MyNVS_Migration& MyNVS_Migration::merge(std::initializer_list<const char*> from, const char* to, nvs_type_t type)
+{
+    step_t step{op_t::MERGE, {}, {key_of(to)}, {type}};
+    for (auto key : from) {
+        step.from.push_back(key_of(key));
+    }
+    return add(std::move(step));
+}
+
+MyNVS_Migration& MyNVS_Migration::erase(const char* key)
+{
+    return add({op_t::ERASE, {key_of(key)}, {}, {}});
+}
+
+esp_err_t MyNVS_Migration::apply(const group_t& group, store_t& store) const
+{
+    for (auto &step : group.steps) {
+        bool missing = false;
+        for (auto &key : step.from) {
+            missing = missing || store.values.find(key) == store.values.end();
+        }
+        if (missing) {
+            MYNVS_LOGD(TAG, "版本%u: 源键%s不存在，跳过", static_cast<unsigned>(group.version), step.from.front().c_str());
+            continue;
+        }
+
+        esp_err_t err = ESP_OK;
+        switch (step.op) {
+            case op_t::RENAME: {
+                auto value = store.values[step.from[0]];
+                store.remove(step.from[0]);
+                store.set(step.to[0], std::move(value));
+                break;
+            }
+            case op_t::RETYPE: {
+                auto &value = store.values[step.from[0]];
+                nvs_type_t type = step.types[0];
+                if (value.type == type) {
+                    break;
+                }
+                value_t converted{type, {}};
+                if (nvs_integer_size(value.type) && nvs_integer_size(type)) {
+                    err = convert_integer(value.data, value.type, type, converted.data);
+                } else if (is_bytes_type(value.type) && is_bytes_type(type)) {
+                    auto bytes = bytes_of(value.data, value.type);
+                    err = value_from_bytes(bytes.data(), bytes.size(), type, converted.data);
+                } else {
+                    err = ESP_ERR_NOT_SUPPORTED;
+                }
+                if (err == ESP_OK) {
+                    store.set(step.from[0], std::move(converted));
+                }
+                break;
+            }
+            case op_t::SPLIT: {
+                auto source = store.values[step.from[0]];
+                auto bytes = bytes_of(source.data, source.type);
+                size_t offset = 0;
+                std::vector<value_t> parts;
+                for (size_t i = 0; i < step.to.size() && err == ESP_OK; i++) {
+                    size_t width = nvs_integer_size(step.types[i]);
+                    size_t length = width ? width : bytes.size() - offset;
+                    if (offset + length > bytes.size() || (!width && i + 1 != step.to.size())) {
+                        err = ESP_ERR_INVALID_SIZE;
+                        break;
+                    }
+                    parts.push_back({step.types[i], {}});
+                    err = value_from_bytes(bytes.data() + offset, length, step.types[i], parts.back().data);
+                    offset += length;
+                }
+                if (err == ESP_OK) {
+                    store.remove(step.from[0]);
+                    for (size_t i = 0; i < parts.size(); i++) {
+                        store.set(step.to[i], std::move(parts[i]));
+                    }
+                }
+                break;
+            }
+            case op_t::MERGE: {
+                std::vector<uint8_t> bytes;
+                for (auto &key : step.from) {
+                    auto &value = store.values[key];
+                    auto part = bytes_of(value.data, value.type);
+                    bytes.insert(bytes.end(), part.begin(), part.end());
+                }
+                value_t merged{step.types[0], {}};
+                err = value_from_bytes(bytes.data(), bytes.size(), merged.type, merged.data);
+                if (err == ESP_OK) {
+                    for (auto &key : step.from) {
+                        store.remove(key);
+                    }
+                    store.set(step.to[0], std::move(merged));
+                }
+                break;
+            }
+            case op_t::ERASE:
+                store.remove(step.from[0]);
+                break;
+        }
+        if (err != ESP_OK) {
+            MYNVS_LOGE(TAG, "版本%u: 处理键%s失败: %s", static_cast<unsigned>(group.version), step.from.front().c_str(), esp_err_to_name(err));
+            return err;
+        }
+    }
+    return ESP_OK;
+}
+
+esp_err_t MyNVS::migrate(const MyNVS_Migration& migration)
+{
+    if (!migration.valid()) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    // 快速路径：已是最新版本时只需一次读取
+    uint32_t current = 0;
+    auto err = read(MyNVS_Migration::SCHEMA_KEY, current);
+    if (err == ESP_OK && current >= migration.latest()) {
+        return ESP_OK;
+    }
+    if (err != ESP_OK && err != ESP_ERR_NVS_NOT_FOUND) {
+        return err;
+    }
+
+    // 已提交版本中变更的键及最终事件类型，释放槽位锁后统一通知
+    std::map<std::string, my_nvs_event_type_t> changed;
+    {
+        std::unique_lock<std::mutex> lock;
+        err = lock_slot(lock, true);
+        if (err != ESP_OK) {
+            return err;
+        }
+        // 加锁后重新读取，避免与其他任务重复迁移
+        current = 0;
+        err = nvs_get_u32(m_nvs->handle, MyNVS_Migration::SCHEMA_KEY, &current);
+        if (err != ESP_OK && err != ESP_ERR_NVS_NOT_FOUND) {
+            return err;
+        }
+
+        // 通过名字空间迭代器一次性加载
+        std::shared_ptr<const MyNVS_Snapshot> snapshot;
+        err = MyNVS_Snapshot::load(m_nvs->handle, snapshot);
+        if (err != ESP_OK) {
+            return err;
+        }
+        MyNVS_Migration::store_t store;
+        snapshot->for_each([&store](const char* key, nvs_type_t type, const void* data, size_t length) {
+            auto bytes = static_cast<const uint8_t*>(data);
+            store.values[key] = {type, std::vector<uint8_t>(bytes, bytes + length)};
+        });
+        snapshot.reset();
+
+        // 写入中途失败时恢复本版本涉及的键（含版本号）至执行前的值，执行前不存在的键删除
+        auto rollback = [this](const std::map<std::string, MyNVS_Migration::value_t>& before, const MyNVS_Migration::store_t& store) {
+            std::set<std::string> keys(store.dirty);
+            keys.insert(store.erased.begin(), store.erased.end());
+            keys.insert(MyNVS_Migration::SCHEMA_KEY);
+            for (auto &key : keys) {
+                auto it = before.find(key);
+                auto undo_err = it != before.end()
+                    ? set_value(m_nvs->handle, key.c_str(), it->second.type, it->second.data.data(), it->second.data.size())
+                    : nvs_erase_key(m_nvs->handle, key.c_str());
+                if (undo_err != ESP_OK && undo_err != ESP_ERR_NVS_NOT_FOUND) {
+                    MYNVS_LOGE(TAG, "回滚键%s失败: %s", key.c_str(), esp_err_to_name(undo_err));
+                }
+            }
+            nvs_commit(m_nvs->handle);
+        };
+
+        for (auto &group : migration.m_groups) {
+            if (group.version <= current) {
+                continue;
+            }
+            auto before = store.values;
+            store.dirty.clear();
+            store.erased.clear();
+            err = migration.apply(group, store);
+            // 首次写入Flash前校验本版本全部待写入的值
+            for (auto it = store.dirty.begin(); err == ESP_OK && it != store.dirty.end(); ++it) {
+                auto &value = store.values[*it];
+                err = check_value(value.type, value.data.data(), value.data.size());
+                if (err != ESP_OK) {
+                    MYNVS_LOGE(TAG, "版本%u: 键%s的值无效", static_cast<unsigned>(group.version), it->c_str());
+                }
+            }
+            if (err != ESP_OK) {
+                break;
+            }
+#if CONFIG_MYNVS_WARM_CACHE
+            MyNVS_WarmCache::invalidate_namespace(m_nvs->cache_id);
+#endif
+            for (auto it = store.dirty.begin(); err == ESP_OK && it != store.dirty.end(); ++it) {
+                auto &value = store.values[*it];
+                err = set_value(m_nvs->handle, it->c_str(), value.type, value.data.data(), value.data.size());
+            }
+            for (auto it = store.erased.begin(); err == ESP_OK && it != store.erased.end(); ++it) {
+                err = nvs_erase_key(m_nvs->handle, it->c_str());
+                err = err == ESP_ERR_NVS_NOT_FOUND ? ESP_OK : err;
+            }
+            if (err == ESP_OK) {
+                err = nvs_set_u32(m_nvs->handle, MyNVS_Migration::SCHEMA_KEY, group.version);
+            }
+            if (err == ESP_OK) {
+                err = nvs_commit(m_nvs->handle);
+            }
+            if (err != ESP_OK) {
+                MYNVS_LOGE(TAG, "版本%u写入失败，回滚: %s", static_cast<unsigned>(group.version), esp_err_to_name(err));
+                rollback(before, store);
+                break;
+            }
+            MYNVS_LOGI(TAG, "名字空间%s迁移至版本%u: 写入%u个键，删除%u个键", m_nvs->name_space.c_str(), static_cast<unsigned>(group.version),
+                static_cast<unsigned>(store.dirty.size()), static_cast<unsigned>(store.erased.size()));
+            for (auto &key : store.dirty) {
+                changed[key] = MY_NVS_EVENT_WRITE;
+            }
+            for (auto &key : store.erased) {
+                changed[key] = MY_NVS_EVENT_ERASE;
+            }
+            changed[MyNVS_Migration::SCHEMA_KEY] = MY_NVS_EVENT_WRITE;
+            // 同步内存视图中的版本号，后续版本回滚时恢复为本版本
+            auto &schema = store.values[MyNVS_Migration::SCHEMA_KEY];
+            schema.type = NVS_TYPE_U32;
+            schema.data.resize(sizeof(group.version));
+            memcpy(schema.data.data(), &group.version, sizeof(group.version));
+            current = group.version;
+        }
+    }
+    if (changed.empty()) {
+        return err;
+    }
+    // 已提交的版本逐键通知，之后刷新快照并通知提交；之前版本已提交时仍返回失败版本的错误
+    if (m_manager->has_watchers()) {
+        std::vector<my_nvs_event_t> events;
+        for (auto &[key, type] : changed) {
+            events.push_back(MyNVS_Manager::make_event(m_nvs, type, key.c_str()));
+        }
+        notify_events(events);
+    }
+    auto commit_err = commit();
+    return err != ESP_OK ? err : commit_err;
+}
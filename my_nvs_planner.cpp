@@ -0,0 +1,79 @@
+/*
+ *             Copyright [2025] [samllin]
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *        http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+
+#include "my_nvs_planner.hpp"
+
+static size_t entries_of(size_t length)
+{
+    return (length + MyNVS_Planner::ENTRY_SIZE - 1) / MyNVS_Planner::ENTRY_SIZE;
+}
+
+// 字符串：1个头条目 + 数据条目（含结尾'\0'）
+size_t MyNVS_Planner::string_entries(size_t length)
+{
+    return 1 + entries_of(length + 1);
+}
+
+// Blob：按页内最大长度分块，每块1个头条目 + 数据条目，另加1个索引条目
+// 起始页剩余空间不足时首块会被截短，因此按多一个分块头估算
+size_t MyNVS_Planner::blob_entries(size_t length)
+{
+    size_t chunks = (length + ITEM_MAX_DATA - 1) / ITEM_MAX_DATA + 1;
+    return entries_of(length) + chunks + 1;
+}
+
+void MyNVS_Planner::add_span(size_t entries, size_t span)
+{
+    m_entries += entries;
+    if (span > m_max_span) {
+        m_max_span = span;
+    }
+}
+
+MyNVS_Planner& MyNVS_Planner::add_items(size_t count)
+{
+    add_span(count, count ? 1 : 0);
+    return *this;
+}
+
+MyNVS_Planner& MyNVS_Planner::add_string(size_t length)
+{
+    add_span(string_entries(length), string_entries(length));
+    return *this;
+}
+
+// Blob分块会按当前页剩余空间截短，换页时最多浪费一个头条目加一个数据条目
+MyNVS_Planner& MyNVS_Planner::add_blob(size_t length)
+{
+    add_span(blob_entries(length), length ? 2 : 1);
+    return *this;
+}
+
+void MyNVS_Planner::clear()
+{
+    m_entries = 0;
+    m_max_span = 0;
+}
+
+// 变长数据放不进当前页剩余空间时，NVS会换页，最坏情况下每页浪费max_span - 1个条目
+size_t MyNVS_Planner::reserve() const
+{
+    if (m_max_span <= 1) {
+        return 0;
+    }
+    size_t pages = (m_entries + PAGE_ENTRIES - 1) / PAGE_ENTRIES;
+    return pages * (m_max_span - 1);
+}
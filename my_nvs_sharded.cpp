@@ -0,0 +1,161 @@
+/*
+ *             Copyright [2025] [samllin]
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *        http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+
+#include <stdio.h>
+#include <string.h>
+#include "esp_log.h"
+#include "my_nvs_log.hpp"
+#include "my_nvs_planner.hpp"
+#include "my_nvs_sharded.hpp"
+
+#define TAG "MyNVS_Sharded"
+
+#define SHARD_SUFFIX_LENGTH     2   // 单分区分片时名字空间序号的最大位数
+
+MyNVS_Sharded::MyNVS_Sharded(std::initializer_list<const char*> partitions, const char* name_space, nvs_open_mode_t mode)
+{
+    for (auto partition : partitions) {
+        add_shard(partition, name_space, mode);
+    }
+}
+
+MyNVS_Sharded::MyNVS_Sharded(const char* partition, const char* name_space, size_t count, nvs_open_mode_t mode)
+{
+    if (count == 0 || count > 100) {
+        MYNVS_LOGE(TAG, "分片数须为1~100: %u", static_cast<unsigned>(count));
+        return;
+    }
+    char shard_name[NAMESPACE_LENGTH + 1];
+    int base_length = static_cast<int>(NAMESPACE_LENGTH - SHARD_SUFFIX_LENGTH);
+    for (size_t i = 0; i < count; i++) {
+        snprintf(shard_name, sizeof(shard_name), "%.*s%u", base_length, name_space ? name_space : "", static_cast<unsigned>(i));
+        add_shard(partition, shard_name, mode);
+    }
+}
+
+void MyNVS_Sharded::add_shard(const char* partition, const char* name_space, nvs_open_mode_t mode)
+{
+    auto shard = std::make_unique<shard_t>();
+    shard->nvs = std::make_unique<MyNVS>(partition, name_space, mode);
+    shard->partition = partition;
+    shard->name_space = name_space;
+    if (!shard->nvs->opened()) {
+        MYNVS_LOGE(TAG, "打开分片[%s:%s]失败，非默认分区须先调用nvs_flash_init_partition", partition, name_space);
+    }
+    m_shards.push_back(std::move(shard));
+}
+
+bool MyNVS_Sharded::opened() const
+{
+    if (m_shards.empty()) {
+        return false;
+    }
+    for (auto &shard : m_shards) {
+        if (!shard->nvs->opened()) {
+            return false;
+        }
+    }
+    return true;
+}
+
+// FNV-1a，只取NVS实际保存的键名长度
+size_t MyNVS_Sharded::shard_of(const char* key) const
+{
+    if (m_shards.empty() || key == nullptr) {
+        return 0;
+    }
+    uint32_t hash = 2166136261u;
+    for (size_t i = 0; i < KEY_LENGTH && key[i] != '\0'; i++) {
+        hash ^= static_cast<uint8_t>(key[i]);
+        hash *= 16777619u;
+    }
+    return hash % m_shards.size();
+}
+
+MyNVS* MyNVS_Sharded::route(const char* key, bool write)
+{
+    if (m_shards.empty()) {
+        MYNVS_LOGE(TAG, "访问%s失败: 没有可用的分片", key ? key : "");
+        return nullptr;
+    }
+    auto &shard = *m_shards[shard_of(key)];
+    (write ? shard.writes : shard.reads).fetch_add(1, std::memory_order_relaxed);
+    return shard.nvs.get();
+}
+
+esp_err_t MyNVS_Sharded::find(const char* key, nvs_type_t* out_type)
+{
+    auto nvs = route(key, false);
+    if (nvs == nullptr) {
+        return ESP_FAIL;
+    }
+    nvs_type_t type;
+    return nvs->find(key, out_type ? out_type : &type);
+}
+
+esp_err_t MyNVS_Sharded::erase_key(const char* key)
+{
+    auto nvs = route(key, true);
+    return nvs ? nvs->erase_key(key) : ESP_FAIL;
+}
+
+esp_err_t MyNVS_Sharded::commit_all()
+{
+    esp_err_t result = m_shards.empty() ? ESP_FAIL : ESP_OK;
+    for (auto &shard : m_shards) {
+        auto err = shard->nvs->commit();
+        if (err != ESP_OK && result == ESP_OK) {
+            result = err;
+        }
+    }
+    return result;
+}
+
+esp_err_t MyNVS_Sharded::for_each(const std::function<void(size_t shard, const nvs_entry_info_t& info)>& visitor, nvs_type_t type)
+{
+    for (size_t i = 0; i < m_shards.size(); i++) {
+        auto err = m_shards[i]->nvs->for_each([&visitor, i](const nvs_entry_info_t& info) {
+            visitor(i, info);
+        }, type);
+        if (err != ESP_OK) {
+            return err;
+        }
+    }
+    return ESP_OK;
+}
+
+esp_err_t MyNVS_Sharded::stats(std::vector<my_nvs_shard_stats_t>& out)
+{
+    out.clear();
+    for (auto &shard : m_shards) {
+        my_nvs_capacity_t capacity = {};
+        auto err = shard->nvs->capacity(&capacity);
+        if (err != ESP_OK) {
+            return err;
+        }
+        out.push_back({shard->partition, shard->name_space, shard->reads.load(std::memory_order_relaxed),
+            shard->writes.load(std::memory_order_relaxed), capacity.namespace_entries});
+    }
+    return ESP_OK;
+}
+
+void MyNVS_Sharded::reset_stats()
+{
+    for (auto &shard : m_shards) {
+        shard->reads.store(0, std::memory_order_relaxed);
+        shard->writes.store(0, std::memory_order_relaxed);
+    }
+}
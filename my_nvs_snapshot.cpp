@@ -0,0 +1,189 @@
+/*
+ *             Copyright [2025] [samllin]
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *        http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+
+#include <string.h>
+#include <algorithm>
+#include "esp_log.h"
+#include "my_nvs_log.hpp"
+#include "my_nvs_snapshot.hpp"
+
+#define TAG "MyNVS_Snapshot"
+
+// 快照内键名按NVS的截断规则比较
+static int compare_key(const char* a, const char* b)
+{
+    return strncmp(a, b, NVS_KEY_NAME_MAX_SIZE - 1);
+}
+
+esp_err_t MyNVS_Snapshot::load(nvs_handle_t handle, std::shared_ptr<const MyNVS_Snapshot>& out)
+{
+    std::shared_ptr<MyNVS_Snapshot> snapshot(new MyNVS_Snapshot);
+    nvs_iterator_t it = nullptr;
+    auto err = nvs_entry_find_in_handle(handle, NVS_TYPE_ANY, &it);
+    while (err == ESP_OK) {
+        nvs_entry_info_t info;
+        nvs_entry_info(it, &info);
+
+        entry_t entry = {};
+        memcpy(entry.key, info.key, sizeof(entry.key));
+        entry.key[sizeof(entry.key) - 1] = '\0';
+        entry.type = info.type;
+        size_t length = nvs_integer_size(info.type);
+        if (length != 0) {
+            err = mynvs_detail::get_integer(handle, info.key, info.type, &entry.value);
+        } else if (info.type == NVS_TYPE_STR || info.type == NVS_TYPE_BLOB) {
+            err = info.type == NVS_TYPE_STR ? nvs_get_str(handle, info.key, nullptr, &length)
+                                            : nvs_get_blob(handle, info.key, nullptr, &length);
+            if (err == ESP_OK) {
+                entry.value = snapshot->m_pool.size();
+                snapshot->m_pool.resize(snapshot->m_pool.size() + length);
+                auto data = snapshot->m_pool.data() + entry.value;
+                err = info.type == NVS_TYPE_STR ? nvs_get_str(handle, info.key, reinterpret_cast<char*>(data), &length)
+                                                : nvs_get_blob(handle, info.key, data, &length);
+            }
+        } else {
+            err = ESP_ERR_NOT_SUPPORTED;
+        }
+        if (err != ESP_OK) {
+            MYNVS_LOGE(TAG, "加载%s失败: %s", info.key, esp_err_to_name(err));
+            nvs_release_iterator(it);
+            return err;
+        }
+        entry.length = static_cast<uint32_t>(length);
+        snapshot->m_entries.push_back(entry);
+        err = nvs_entry_next(&it);
+    }
+    nvs_release_iterator(it);
+    if (err != ESP_ERR_NVS_NOT_FOUND) {
+        MYNVS_LOGE(TAG, "遍历名字空间失败: %s", esp_err_to_name(err));
+        return err;
+    }
+
+    std::sort(snapshot->m_entries.begin(), snapshot->m_entries.end(), [](const entry_t& a, const entry_t& b) {
+        return compare_key(a.key, b.key) < 0;
+    });
+    snapshot->m_entries.shrink_to_fit();
+    snapshot->m_pool.shrink_to_fit();
+    out = std::move(snapshot);
+    return ESP_OK;
+}
+
+const MyNVS_Snapshot::entry_t* MyNVS_Snapshot::lookup(const char* key) const
+{
+    if (key == nullptr || *key == '\0') {
+        return nullptr;
+    }
+    auto it = std::lower_bound(m_entries.begin(), m_entries.end(), key, [](const entry_t& entry, const char* k) {
+        return compare_key(entry.key, k) < 0;
+    });
+    if (it == m_entries.end() || compare_key(it->key, key) != 0) {
+        return nullptr;
+    }
+    return &(*it);
+}
+
+const void* MyNVS_Snapshot::data_of(const entry_t& entry) const
+{
+    return nvs_integer_size(entry.type) ? static_cast<const void*>(&entry.value) : m_pool.data() + entry.value;
+}
+
+esp_err_t MyNVS_Snapshot::read_item(const char* key, nvs_type_t type, void* out) const
+{
+    auto entry = lookup(key);
+    if (entry == nullptr) {
+        return ESP_ERR_NVS_NOT_FOUND;
+    }
+    if (entry->type != type) {
+        return ESP_ERR_NVS_TYPE_MISMATCH;
+    }
+    memcpy(out, &entry->value, entry->length);
+    return ESP_OK;
+}
+
+esp_err_t MyNVS_Snapshot::read(const char* key, std::string& value) const
+{
+    auto entry = lookup(key);
+    if (entry == nullptr) {
+        return ESP_ERR_NVS_NOT_FOUND;
+    }
+    if (entry->type != NVS_TYPE_STR) {
+        return ESP_ERR_NVS_TYPE_MISMATCH;
+    }
+    auto data = static_cast<const char*>(data_of(*entry));
+    value.assign(data, entry->length ? entry->length - 1 : 0);
+    return ESP_OK;
+}
+
+esp_err_t MyNVS_Snapshot::read(const char* key, void* value, size_t* length) const
+{
+    if (length == nullptr) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    auto entry = lookup(key);
+    if (entry == nullptr) {
+        return ESP_ERR_NVS_NOT_FOUND;
+    }
+    if (entry->type != NVS_TYPE_BLOB) {
+        return ESP_ERR_NVS_TYPE_MISMATCH;
+    }
+    // 与nvs_get_blob一致：value为空时仅返回长度
+    if (value == nullptr) {
+        *length = entry->length;
+        return ESP_OK;
+    }
+    if (*length < entry->length) {
+        return ESP_ERR_NVS_INVALID_LENGTH;
+    }
+    memcpy(value, data_of(*entry), entry->length);
+    *length = entry->length;
+    return ESP_OK;
+}
+
+esp_err_t MyNVS_Snapshot::find(const char* key, nvs_type_t* out_type) const
+{
+    auto entry = lookup(key);
+    if (entry == nullptr) {
+        return ESP_ERR_NVS_NOT_FOUND;
+    }
+    if (out_type) {
+        *out_type = entry->type;
+    }
+    return ESP_OK;
+}
+
+void MyNVS_Snapshot::for_each(const visitor_t& visitor) const
+{
+    for (auto &entry : m_entries) {
+        visitor(entry.key, entry.type, data_of(entry), entry.length);
+    }
+}
+
+MyNVS_SnapshotReader::MyNVS_SnapshotReader(MyNVS& nvs)
+    : m_nvs(nvs)
+{
+}
+
+const MyNVS_Snapshot* MyNVS_SnapshotReader::get()
+{
+    // 先读版本号再取快照：若两者之间又发布了新快照，下次调用时版本号不同会再次获取
+    uint32_t version = m_nvs.snapshot_version();
+    if (!m_loaded || version != m_version) {
+        m_snapshot = m_nvs.snapshot();
+        m_version = version;
+        m_loaded = true;
+    }
+    return m_snapshot.get();
+}
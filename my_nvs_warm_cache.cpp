@@ -0,0 +1,409 @@
+/*
+ *             Copyright [2025] [samllin]
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *        http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+
+#include "my_nvs_warm_cache.hpp"
+
+#if CONFIG_MYNVS_WARM_CACHE
+#include <string.h>
+#include <atomic>
+#include <mutex>
+#include "esp_log.h"
+#include "esp_attr.h"
+#include "esp_rom_crc.h"
+#include "my_nvs.hpp"
+#include "my_nvs_log.hpp"
+#if !CONFIG_IDF_TARGET_LINUX
+#include "esp_system.h"
+#endif
+
+#define TAG "MyNVS_WarmCache"
+
+#define WARM_CACHE_MAGIC    0x43574E4D  // "MNWC"
+#define WARM_CACHE_VERSION  3
+#define WARM_CACHE_WAYS     4           // 每组条目数，每个键只能存放在所属组内
+#define WARM_CACHE_SETS     (CONFIG_MYNVS_WARM_CACHE_ENTRIES / WARM_CACHE_WAYS)    // 不足一组的剩余条目不使用
+#define WARM_CACHE_READ_RETRIES     2   // 无锁读取的重试次数，超过后加锁读取
+#define WARM_CACHE_GEN_NAMESPACE    "mynvs_wcgen"   // 各分区中保存名字空间代数的名字空间，键名为名字空间名
+
+struct warm_entry_t {
+    uint32_t    ns;                         // 名字空间标识，0表示空条目
+    char        key[NVS_KEY_NAME_MAX_SIZE];
+    uint8_t     type;                       // nvs_type_t
+    uint8_t     reserved[3];
+    uint64_t    bits;                       // 小端原始值
+    uint32_t    crc;                        // 覆盖以上字段
+};
+
+// 名字空间缓存条目所对应的Flash代数，打开名字空间时与Flash中的记录比较
+struct warm_namespace_t {
+    uint32_t    ns;                         // 名字空间标识，0表示空记录
+    uint32_t    generation;
+};
+
+struct warm_region_t {
+    uint32_t    magic;
+    uint16_t    version;
+    uint16_t    count;                      // 条目数，配置变化后视为无效
+    uint32_t    generation;
+    warm_namespace_t namespaces[CONFIG_MAX_NAMESPACE];
+    uint32_t    crc;                        // 覆盖以上字段
+    warm_entry_t entries[CONFIG_MYNVS_WARM_CACHE_ENTRIES];
+};
+
+// 目标芯片上位于RTC no-init内存，深度睡眠及软件复位后保持；主机目标上为普通静态内存
+#if CONFIG_IDF_TARGET_LINUX
+static warm_region_t s_region;
+#else
+static RTC_NOINIT_ATTR warm_region_t s_region;
+#endif
+// 修改条目及区域头部时持有s_mutex，并在修改前后各递增一次所在组的序列号（奇数表示正在修改）；
+// 读取条目不加锁，序列号为偶数且读取前后一致时结果有效
+static std::mutex s_mutex;
+static std::atomic<uint32_t> s_sequence[WARM_CACHE_SETS];
+static std::atomic<uint32_t> s_hits{0};
+static std::atomic<uint32_t> s_misses{0};
+static bool s_restored = false;
+static bool s_dirty[CONFIG_MAX_NAMESPACE];  // 本次启动以来名字空间有修改且尚未提交新代数
+static size_t s_victim = 0;                 // 名字空间记录已满时轮流替换
+
+static uint32_t fnv1a(uint32_t hash, const char* str, size_t max_length)
+{
+    for (size_t i = 0; i < max_length && str[i] != '\0'; i++) {
+        hash ^= static_cast<uint8_t>(str[i]);
+        hash *= 16777619u;
+    }
+    return hash;
+}
+
+static uint32_t entry_crc(const warm_entry_t& entry)
+{
+    return esp_rom_crc32_le(0, reinterpret_cast<const uint8_t*>(&entry), offsetof(warm_entry_t, crc));
+}
+
+static uint32_t header_crc()
+{
+    return esp_rom_crc32_le(0, reinterpret_cast<const uint8_t*>(&s_region), offsetof(warm_region_t, crc));
+}
+
+static warm_entry_t* set_entries(size_t set)
+{
+    return &s_region.entries[set * WARM_CACHE_WAYS];
+}
+
+static void begin_write(size_t set)
+{
+    s_sequence[set].fetch_add(1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+}
+
+static void end_write(size_t set)
+{
+    s_sequence[set].fetch_add(1, std::memory_order_release);
+}
+
+static void reset_region()
+{
+    for (size_t set = 0; set < WARM_CACHE_SETS; set++) {
+        begin_write(set);
+    }
+    memset(&s_region, 0, sizeof(s_region));
+    s_region.magic = WARM_CACHE_MAGIC;
+    s_region.version = WARM_CACHE_VERSION;
+    s_region.count = CONFIG_MYNVS_WARM_CACHE_ENTRIES;
+    s_region.crc = header_crc();
+    for (size_t set = 0; set < WARM_CACHE_SETS; set++) {
+        end_write(set);
+    }
+}
+
+static void bump_generation()
+{
+    s_region.generation++;
+    s_region.crc = header_crc();
+}
+
+static int find_namespace(uint32_t ns)
+{
+    for (int i = 0; i < CONFIG_MAX_NAMESPACE; i++) {
+        if (s_region.namespaces[i].ns == ns) {
+            return i;
+        }
+    }
+    return -1;
+}
+
+static void drop_namespace(uint32_t ns)
+{
+    for (size_t set = 0; set < WARM_CACHE_SETS; set++) {
+        auto entries = set_entries(set);
+        for (size_t way = 0; way < WARM_CACHE_WAYS; way++) {
+            if (entries[way].ns == ns) {
+                begin_write(set);
+                memset(&entries[way], 0, sizeof(entries[way]));
+                end_write(set);
+            }
+        }
+    }
+}
+
+static void mark_dirty(uint32_t ns)
+{
+    int index = find_namespace(ns);
+    if (index >= 0) {
+        s_dirty[index] = true;
+    }
+}
+
+// Flash中记录的名字空间代数，不存在或读取失败时返回false
+static bool load_generation(const char* partition, const char* name_space, uint32_t* generation)
+{
+    nvs_handle_t handle;
+    if (nvs_open_from_partition(partition, WARM_CACHE_GEN_NAMESPACE, NVS_READONLY, &handle) != ESP_OK) {
+        return false;
+    }
+    auto err = nvs_get_u32(handle, name_space, generation);
+    nvs_close(handle);
+    return err == ESP_OK;
+}
+
+static esp_err_t save_generation(const char* partition, const char* name_space, uint32_t generation)
+{
+    nvs_handle_t handle;
+    auto err = nvs_open_from_partition(partition, WARM_CACHE_GEN_NAMESPACE, NVS_READWRITE, &handle);
+    if (err != ESP_OK) {
+        return err;
+    }
+    err = nvs_set_u32(handle, name_space, generation);
+    if (err == ESP_OK) {
+        err = nvs_commit(handle);
+    }
+    nvs_close(handle);
+    return err;
+}
+
+// 键所在组的序号
+static size_t set_of(uint32_t ns, const char* key)
+{
+    return fnv1a(ns, key, KEY_LENGTH) % WARM_CACHE_SETS;
+}
+
+static warm_entry_t* find_entry(warm_entry_t* entries, uint32_t ns, const char* key)
+{
+    for (size_t way = 0; way < WARM_CACHE_WAYS; way++) {
+        if (entries[way].ns == ns && strncmp(entries[way].key, key, KEY_LENGTH) == 0) {
+            return &entries[way];
+        }
+    }
+    return nullptr;
+}
+
+void MyNVS_WarmCache::init(bool flash_erased)
+{
+    std::lock_guard<std::mutex> lock(s_mutex);
+    bool trusted = !flash_erased;
+#if !CONFIG_IDF_TARGET_LINUX
+    // 上电、外部复位、看门狗等情况下RTC内存内容或Flash状态不可信
+    auto reason = esp_reset_reason();
+    trusted = trusted && (reason == ESP_RST_DEEPSLEEP || reason == ESP_RST_SW);
+#endif
+    trusted = trusted && s_region.magic == WARM_CACHE_MAGIC && s_region.version == WARM_CACHE_VERSION
+        && s_region.count == CONFIG_MYNVS_WARM_CACHE_ENTRIES && s_region.crc == header_crc();
+    s_hits.store(0, std::memory_order_relaxed);
+    s_misses.store(0, std::memory_order_relaxed);
+    s_restored = trusted;
+    memset(s_dirty, 0, sizeof(s_dirty));
+    if (!trusted) {
+        reset_region();
+        return;
+    }
+    // 丢弃写入中途复位造成的损坏条目
+    uint32_t dropped = 0;
+    for (auto &entry : s_region.entries) {
+        if (entry.ns != 0 && entry.crc != entry_crc(entry)) {
+            memset(&entry, 0, sizeof(entry));
+            dropped++;
+        }
+    }
+    MYNVS_LOGI(TAG, "沿用热缓存，代数%u，丢弃损坏条目%u个", static_cast<unsigned>(s_region.generation), static_cast<unsigned>(dropped));
+}
+
+uint32_t MyNVS_WarmCache::namespace_id(const char* partition, const char* name_space)
+{
+    uint32_t hash = fnv1a(2166136261u, partition, NVS_PART_NAME_MAX_SIZE);
+    hash = fnv1a(hash ^ ':', name_space, NVS_KEY_NAME_MAX_SIZE);
+    return hash == 0 ? 1 : hash;
+}
+
+uint32_t MyNVS_WarmCache::attach(const char* partition, const char* name_space)
+{
+    uint32_t ns = namespace_id(partition, name_space);
+    // 只读取Flash中的代数，不在打开时写入Flash
+    uint32_t generation = 0;
+    bool persisted = load_generation(partition, name_space, &generation);
+    std::lock_guard<std::mutex> lock(s_mutex);
+    int index = find_namespace(ns);
+    if (persisted && index >= 0 && s_region.namespaces[index].generation == generation) {
+        return ns;
+    }
+    // 代数不一致、Flash中无记录或未登记：Flash可能在缓存之外被修改，丢弃该名字空间的条目
+    drop_namespace(ns);
+    if (index < 0) {
+        index = find_namespace(0);
+    }
+    if (index < 0) {
+        index = static_cast<int>(s_victim++ % CONFIG_MAX_NAMESPACE);
+        drop_namespace(s_region.namespaces[index].ns);
+    }
+    s_region.namespaces[index] = {ns, generation};
+    // 首次使用或分区被擦除后Flash中无记录：标记为有修改，由下一次成功的提交写入代数
+    s_dirty[index] = !persisted;
+    bump_generation();
+    return ns;
+}
+
+void MyNVS_WarmCache::commit(uint32_t ns, const char* partition, const char* name_space)
+{
+    uint32_t generation;
+    {
+        std::lock_guard<std::mutex> lock(s_mutex);
+        int index = find_namespace(ns);
+        if (index < 0 || !s_dirty[index]) {
+            return;
+        }
+        generation = s_region.namespaces[index].generation + 1;
+    }
+    // 先写Flash再更新记录，两者之间复位时代数不一致，下次打开时丢弃该名字空间的条目
+    auto err = save_generation(partition, name_space, generation);
+    if (err != ESP_OK) {
+        MYNVS_LOGW(TAG, "保存名字空间%s的缓存代数失败: %s", name_space, esp_err_to_name(err));
+        return;
+    }
+    std::lock_guard<std::mutex> lock(s_mutex);
+    int index = find_namespace(ns);
+    if (index >= 0) {
+        s_region.namespaces[index].generation = generation;
+        s_dirty[index] = false;
+        s_region.crc = header_crc();
+    }
+}
+
+bool MyNVS_WarmCache::lookup(uint32_t ns, const char* key, nvs_type_t type, void* out)
+{
+    size_t set = set_of(ns, key);
+    warm_entry_t entries[WARM_CACHE_WAYS];
+    bool copied = false;
+    // 连续失败说明写入者正在修改该组（可能被当前任务抢占），改为加锁读取，避免忙等
+    for (int retry = 0; retry < WARM_CACHE_READ_RETRIES && !copied; retry++) {
+        uint32_t sequence = s_sequence[set].load(std::memory_order_acquire);
+        if (sequence & 1) {
+            continue;
+        }
+        memcpy(entries, set_entries(set), sizeof(entries));
+        std::atomic_thread_fence(std::memory_order_acquire);
+        copied = s_sequence[set].load(std::memory_order_relaxed) == sequence;
+    }
+    if (!copied) {
+        std::lock_guard<std::mutex> lock(s_mutex);
+        memcpy(entries, set_entries(set), sizeof(entries));
+    }
+    auto entry = find_entry(entries, ns, key);
+    if (entry == nullptr || entry->type != type) {
+        s_misses.fetch_add(1, std::memory_order_relaxed);
+        return false;
+    }
+    memcpy(out, &entry->bits, nvs_integer_size(type));
+    s_hits.fetch_add(1, std::memory_order_relaxed);
+    return true;
+}
+
+void MyNVS_WarmCache::store(uint32_t ns, const char* key, nvs_type_t type, const void* value)
+{
+    size_t width = nvs_integer_size(type);
+    if (width == 0) {
+        return;
+    }
+    std::lock_guard<std::mutex> lock(s_mutex);
+    size_t set = set_of(ns, key);
+    auto entries = set_entries(set);
+    auto entry = find_entry(entries, ns, key);
+    if (entry == nullptr) {
+        // 组内优先使用空条目，否则替换首个条目
+        entry = &entries[0];
+        for (size_t way = 0; way < WARM_CACHE_WAYS; way++) {
+            if (entries[way].ns == 0) {
+                entry = &entries[way];
+                break;
+            }
+        }
+    }
+    // 先清除标识再写入，写入中途复位时CRC不匹配
+    begin_write(set);
+    entry->ns = 0;
+    memset(entry->key, 0, sizeof(entry->key));
+    strncpy(entry->key, key, KEY_LENGTH);
+    entry->type = type;
+    entry->bits = 0;
+    memcpy(&entry->bits, value, width);
+    entry->ns = ns;
+    entry->crc = entry_crc(*entry);
+    end_write(set);
+}
+
+void MyNVS_WarmCache::invalidate(uint32_t ns, const char* key)
+{
+    std::lock_guard<std::mutex> lock(s_mutex);
+    size_t set = set_of(ns, key);
+    auto entry = find_entry(set_entries(set), ns, key);
+    if (entry != nullptr) {
+        begin_write(set);
+        memset(entry, 0, sizeof(*entry));
+        end_write(set);
+    }
+    mark_dirty(ns);
+}
+
+void MyNVS_WarmCache::invalidate_namespace(uint32_t ns)
+{
+    std::lock_guard<std::mutex> lock(s_mutex);
+    drop_namespace(ns);
+    mark_dirty(ns);
+    bump_generation();
+}
+
+void MyNVS_WarmCache::clear()
+{
+    std::lock_guard<std::mutex> lock(s_mutex);
+    uint32_t generation = s_region.generation;
+    reset_region();
+    memset(s_dirty, 0, sizeof(s_dirty));
+    s_region.generation = generation;
+    bump_generation();
+}
+
+my_nvs_warm_cache_stats_t MyNVS_WarmCache::stats()
+{
+    std::lock_guard<std::mutex> lock(s_mutex);
+    my_nvs_warm_cache_stats_t stats = {s_hits.load(std::memory_order_relaxed), s_misses.load(std::memory_order_relaxed),
+        s_region.generation, 0, s_restored};
+    for (auto &entry : s_region.entries) {
+        if (entry.ns != 0) {
+            stats.entries++;
+        }
+    }
+    return stats;
+}
+
+#endif
@@ -0,0 +1,123 @@
+/*
+ *             Copyright [2025] [samllin]
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *        http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+
+#include <string.h>
+#include <string>
+#include "unity.h"
+#include "my_nvs.hpp"
+#include "my_nvs_arena.hpp"
+
+static void clear(MyNVS& nvs)
+{
+    TEST_ASSERT_TRUE(nvs.opened());
+    TEST_ASSERT_EQUAL(ESP_OK, nvs.erase_all());
+    TEST_ASSERT_EQUAL(ESP_OK, nvs.commit());
+}
+
+static bool inside(const void* ptr, const uint8_t* buffer, size_t size)
+{
+    auto p = static_cast<const uint8_t*>(ptr);
+    return p >= buffer && p < buffer + size;
+}
+
+TEST_CASE("内存池不足时读取pmr字符串返回ESP_ERR_NO_MEM且不分配", "[arena]")
+{
+    MyNVS nvs("t_arena_read", NVS_READWRITE);
+    clear(nvs);
+    // 超过短字符串优化的长度，读取时必然从内存池分配
+    const std::string text(100, 'a');
+    TEST_ASSERT_EQUAL(ESP_OK, nvs.write("long", text));
+    TEST_ASSERT_EQUAL(ESP_OK, nvs.commit());
+
+    alignas(std::max_align_t) static uint8_t small[64];
+    MyNVS_Arena tight(small, sizeof(small));
+    std::pmr::string value("old", &tight);
+    TEST_ASSERT_EQUAL(ESP_ERR_NO_MEM, nvs.read("long", value, tight));
+    TEST_ASSERT_EQUAL_STRING("old", value.c_str());
+    TEST_ASSERT_EQUAL(0, tight.used());
+    TEST_ASSERT_EQUAL(0, tight.high_water());
+
+    // 字符串未使用该内存池
+    MyNVS_Arena other(small, sizeof(small));
+    TEST_ASSERT_EQUAL(ESP_ERR_INVALID_ARG, nvs.read("long", value, other));
+}
+
+TEST_CASE("内存池足够时读取pmr字符串并记录高水位", "[arena]")
+{
+    MyNVS nvs("t_arena_hw", NVS_READWRITE);
+    clear(nvs);
+    const std::string text(100, 'b');
+    TEST_ASSERT_EQUAL(ESP_OK, nvs.write("long", text));
+    TEST_ASSERT_EQUAL(ESP_OK, nvs.commit());
+
+    alignas(std::max_align_t) static uint8_t buffer[256];
+    MyNVS_Arena arena(buffer, sizeof(buffer));
+    {
+        std::pmr::string value(&arena);
+        TEST_ASSERT_EQUAL(ESP_OK, nvs.read("long", value, arena));
+        TEST_ASSERT_EQUAL_STRING(text.c_str(), value.c_str());
+        TEST_ASSERT_TRUE(inside(value.data(), buffer, sizeof(buffer)));
+        TEST_ASSERT_TRUE(arena.used() >= text.size() + 1);
+        TEST_ASSERT_EQUAL(arena.used(), arena.high_water());
+    }
+    size_t peak = arena.high_water();
+    // release()清空用量，高水位保留；较小的后续分配不改变高水位
+    arena.release();
+    TEST_ASSERT_EQUAL(0, arena.used());
+    TEST_ASSERT_EQUAL(sizeof(buffer), arena.remaining());
+    TEST_ASSERT_EQUAL(peak, arena.high_water());
+    TEST_ASSERT_TRUE(arena.allocate(8, 1) != nullptr);
+    TEST_ASSERT_EQUAL(8, arena.used());
+    TEST_ASSERT_EQUAL(peak, arena.high_water());
+}
+
+TEST_CASE("批量加载先统计容量，不足时返回ESP_ERR_NO_MEM", "[arena]")
+{
+    MyNVS nvs("t_arena_load", NVS_READWRITE);
+    clear(nvs);
+    const std::string text(100, 'c');
+    TEST_ASSERT_EQUAL(ESP_OK, nvs.write("s.a", "hello"));
+    TEST_ASSERT_EQUAL(ESP_OK, nvs.write("s.b", text));
+    TEST_ASSERT_EQUAL(ESP_OK, nvs.write("x", "skip"));
+    TEST_ASSERT_EQUAL(ESP_OK, nvs.commit());
+
+    // 键名与值共需(4 + 6) + (4 + 101)字节，另加out的元素数组
+    alignas(std::max_align_t) static uint8_t small[128];
+    MyNVS_Arena tight(small, sizeof(small));
+    std::pmr::vector<my_nvs_arena_value_t> none(&tight);
+    TEST_ASSERT_EQUAL(ESP_ERR_NO_MEM, nvs.load_strings("s.", tight, none));
+    TEST_ASSERT_TRUE(none.empty());
+    TEST_ASSERT_EQUAL(0, tight.used());
+    TEST_ASSERT_EQUAL(0, tight.high_water());
+
+    alignas(std::max_align_t) static uint8_t buffer[512];
+    MyNVS_Arena arena(buffer, sizeof(buffer));
+    std::pmr::vector<my_nvs_arena_value_t> values(&arena);
+    TEST_ASSERT_EQUAL(ESP_OK, nvs.load_strings("s.", arena, values));
+    TEST_ASSERT_EQUAL(2, values.size());
+    for (auto& v : values) {
+        TEST_ASSERT_TRUE(inside(v.key, buffer, sizeof(buffer)));
+        TEST_ASSERT_TRUE(inside(v.data, buffer, sizeof(buffer)));
+        if (strcmp(v.key, "s.a") == 0) {
+            TEST_ASSERT_TRUE(v.view() == "hello");
+        } else {
+            TEST_ASSERT_EQUAL_STRING("s.b", v.key);
+            TEST_ASSERT_TRUE(v.view() == text);
+        }
+    }
+    TEST_ASSERT_TRUE(arena.used() >= (4 + 6) + (4 + 101) + 2 * sizeof(my_nvs_arena_value_t));
+    TEST_ASSERT_EQUAL(arena.used(), arena.high_water());
+}
@@ -0,0 +1,134 @@
+/*
+ *             Copyright [2025] [samllin]
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *        http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+
+#include <vector>
+#include "unity.h"
+#include "my_nvs.hpp"
+#include "my_nvs_dual_record.hpp"
+
+struct record_t {
+    uint32_t    id;
+    float       coeffs[16];
+};
+
+static void clear(MyNVS& nvs)
+{
+    TEST_ASSERT_TRUE(nvs.opened());
+    TEST_ASSERT_EQUAL(ESP_OK, nvs.erase_all());
+    TEST_ASSERT_EQUAL(ESP_OK, nvs.commit());
+}
+
+static record_t make_record(uint32_t id)
+{
+    record_t record{};
+    record.id = id;
+    record.coeffs[15] = static_cast<float>(id);
+    return record;
+}
+
+// 写入三次：A(代数1,id1) B(代数2,id2) A(代数3,id3)，指针指向A
+static void store_three(MyNVS& nvs)
+{
+    MyNVS_DualRecord<record_t> record(nvs, "rec");
+    for (uint32_t id = 1; id <= 3; id++) {
+        TEST_ASSERT_EQUAL(ESP_OK, record.store(make_record(id)));
+    }
+    TEST_ASSERT_EQUAL(0, record.active());
+    TEST_ASSERT_EQUAL_UINT32(3, record.generation());
+}
+
+static void expect_load(MyNVS& nvs, uint32_t id, int active)
+{
+    MyNVS_DualRecord<record_t> record(nvs, "rec");
+    record_t value{};
+    TEST_ASSERT_EQUAL(ESP_OK, record.load(value));
+    TEST_ASSERT_EQUAL_UINT32(id, value.id);
+    TEST_ASSERT_TRUE(value.coeffs[15] == static_cast<float>(id));
+    TEST_ASSERT_EQUAL(active, record.active());
+}
+
+TEST_CASE("活动副本损坏时回退到另一副本，均损坏时返回CRC错误", "[dual_record]")
+{
+    MyNVS nvs("t_dual_crc", NVS_READWRITE);
+    clear(nvs);
+    MyNVS_DualRecord<record_t> empty(nvs, "rec");
+    record_t value{};
+    TEST_ASSERT_EQUAL(ESP_ERR_NVS_NOT_FOUND, empty.load(value));
+    store_three(nvs);
+
+    // 翻转活动副本A中的一个数据字节
+    std::vector<uint8_t> blob(64 + sizeof(record_t));
+    size_t length = blob.size();
+    TEST_ASSERT_EQUAL(ESP_OK, nvs.read("rec.a", blob.data(), &length));
+    blob[length - 1] ^= 0x01;
+    TEST_ASSERT_EQUAL(ESP_OK, nvs.write("rec.a", blob.data(), length));
+    expect_load(nvs, 2, 1);
+
+    // 长度不符同样视为无效
+    TEST_ASSERT_EQUAL(ESP_OK, nvs.write("rec.b", blob.data(), length - 1));
+    TEST_ASSERT_EQUAL(ESP_ERR_INVALID_CRC, empty.load(value));
+    TEST_ASSERT_EQUAL(-1, empty.active());
+
+    // 均损坏后重新写入从A开始
+    MyNVS_DualRecord<record_t> record(nvs, "rec");
+    TEST_ASSERT_EQUAL(ESP_OK, record.store(make_record(9)));
+    TEST_ASSERT_EQUAL(0, record.active());
+    expect_load(nvs, 9, 0);
+}
+
+TEST_CASE("切换指针前中断时仍读取旧副本", "[dual_record]")
+{
+    MyNVS nvs("t_dual_cut", NVS_READWRITE);
+    clear(nvs);
+    store_three(nvs);
+    // 模拟第三次写入在新副本提交后、指针切换前复位：指针仍指向B
+    TEST_ASSERT_EQUAL(ESP_OK, nvs.write("rec.p", static_cast<uint8_t>(1)));
+    expect_load(nvs, 2, 1);
+
+    // 新副本只写入一半同样不影响读取
+    TEST_ASSERT_EQUAL(ESP_OK, nvs.write("rec.a", "torn", 4));
+    expect_load(nvs, 2, 1);
+
+    // 之后的写入覆盖非活动副本A
+    MyNVS_DualRecord<record_t> record(nvs, "rec");
+    TEST_ASSERT_EQUAL(ESP_OK, record.store(make_record(4)));
+    TEST_ASSERT_EQUAL(0, record.active());
+    TEST_ASSERT_EQUAL_UINT32(3, record.generation());
+    expect_load(nvs, 4, 0);
+}
+
+TEST_CASE("指针不存在或损坏时按代数选择副本", "[dual_record]")
+{
+    MyNVS nvs("t_dual_ptr", NVS_READWRITE);
+    clear(nvs);
+    store_three(nvs);
+    TEST_ASSERT_EQUAL(ESP_OK, nvs.write("rec.p", static_cast<uint8_t>(1)));
+
+    // 指针不存在：A的代数3较新
+    TEST_ASSERT_EQUAL(ESP_OK, nvs.erase_key("rec.p"));
+    expect_load(nvs, 3, 0);
+
+    // 指针值越界或类型错误
+    TEST_ASSERT_EQUAL(ESP_OK, nvs.write("rec.p", static_cast<uint8_t>(7)));
+    expect_load(nvs, 3, 0);
+    TEST_ASSERT_EQUAL(ESP_OK, nvs.erase_key("rec.p"));
+    TEST_ASSERT_EQUAL(ESP_OK, nvs.write("rec.p", static_cast<uint32_t>(1)));
+    expect_load(nvs, 3, 0);
+
+    // 指针损坏且较新的副本也损坏时使用另一副本
+    TEST_ASSERT_EQUAL(ESP_OK, nvs.write("rec.a", "torn", 4));
+    expect_load(nvs, 2, 1);
+}
@@ -0,0 +1,136 @@
+/*
+ *             Copyright [2025] [samllin]
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *        http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+
+#include <stddef.h>
+#include <string.h>
+#include <string>
+#include <vector>
+#include "unity.h"
+#include "my_nvs.hpp"
+#include "my_nvs_image.hpp"
+
+// 由test_image.csv经tools/mynvs_image.py生成，见main/CMakeLists.txt
+extern const uint8_t test_image_start[] asm("_binary_test_image_bin_start");
+extern const uint8_t test_image_end[]   asm("_binary_test_image_bin_end");
+
+static size_t test_image_size()
+{
+    return static_cast<size_t>(test_image_end - test_image_start);
+}
+
+static void clear(MyNVS& nvs)
+{
+    TEST_ASSERT_TRUE(nvs.opened());
+    TEST_ASSERT_EQUAL(ESP_OK, nvs.erase_all());
+    TEST_ASSERT_EQUAL(ESP_OK, nvs.commit());
+}
+
+static void check_values(MyNVS& nvs)
+{
+    uint64_t big = 0;
+    int32_t offset = 0;
+    uint8_t volume = 0;
+    std::string name;
+    uint8_t calib[8] = {};
+    size_t length = sizeof(calib);
+    const uint8_t expected[] = {0x0a, 0x0b, 0x0c, 0x0d};
+    TEST_ASSERT_EQUAL(ESP_OK, nvs.read("big", big));
+    TEST_ASSERT_TRUE(big == UINT64_MAX);
+    TEST_ASSERT_EQUAL(ESP_OK, nvs.read("offset", offset));
+    TEST_ASSERT_EQUAL_INT32(-12, offset);
+    TEST_ASSERT_EQUAL(ESP_OK, nvs.read("volume", volume));
+    TEST_ASSERT_EQUAL_UINT8(30, volume);
+    TEST_ASSERT_EQUAL(ESP_OK, nvs.read("name", name));
+    TEST_ASSERT_EQUAL_STRING("dev,01", name.c_str());
+    TEST_ASSERT_EQUAL(ESP_OK, nvs.read("calib", calib, &length));
+    TEST_ASSERT_EQUAL(sizeof(expected), length);
+    TEST_ASSERT_EQUAL_HEX8_ARRAY(expected, calib, sizeof(expected));
+}
+
+TEST_CASE("导入mynvs_image.py生成的镜像后导出结果逐字节一致", "[image]")
+{
+    MyNVS nvs("t_image", NVS_READWRITE);
+    clear(nvs);
+    nvs.write("stale", 1u);
+    nvs.commit();
+
+    TEST_ASSERT_EQUAL(ESP_OK, nvs.import_namespace(test_image_start, test_image_size(), true));
+    TEST_ASSERT_EQUAL(ESP_ERR_NVS_NOT_FOUND, nvs.find("stale"));
+    check_values(nvs);
+
+    std::vector<uint8_t> image;
+    TEST_ASSERT_EQUAL(ESP_OK, nvs.export_namespace(image));
+    TEST_ASSERT_EQUAL(test_image_size(), image.size());
+    TEST_ASSERT_EQUAL_HEX8_ARRAY(test_image_start, image.data(), image.size());
+}
+
+TEST_CASE("导出的镜像可导入到其他名字空间", "[image]")
+{
+    std::vector<uint8_t> image;
+    {
+        MyNVS source("t_image_src", NVS_READWRITE);
+        clear(source);
+        TEST_ASSERT_EQUAL(ESP_OK, source.import_namespace(test_image_start, test_image_size(), true));
+        TEST_ASSERT_EQUAL(ESP_OK, source.export_namespace(image));
+    }
+    MyNVS target("t_image_dst", NVS_READWRITE);
+    clear(target);
+    TEST_ASSERT_EQUAL(ESP_OK, target.import_namespace(image, true));
+    check_values(target);
+}
+
+TEST_CASE("校验失败的镜像不写入名字空间", "[image]")
+{
+    MyNVS nvs("t_image_crc", NVS_READWRITE);
+    clear(nvs);
+    nvs.write("keep", 7u);
+    nvs.commit();
+
+    std::vector<uint8_t> image(test_image_start, test_image_end);
+    // CRC同样覆盖头部：条目数被改写时拒绝导入
+    image[offsetof(my_nvs_image_header_t, count)] ^= 0x01;
+    TEST_ASSERT_EQUAL(ESP_ERR_INVALID_CRC, nvs.import_namespace(image, true));
+    image[offsetof(my_nvs_image_header_t, count)] ^= 0x01;
+    image.back() ^= 0x01;
+    TEST_ASSERT_EQUAL(ESP_ERR_INVALID_CRC, nvs.import_namespace(image, true));
+    image.resize(image.size() / 2);
+    TEST_ASSERT_NOT_EQUAL(ESP_OK, nvs.import_namespace(image, true));
+
+    uint32_t keep = 0;
+    TEST_ASSERT_EQUAL(ESP_OK, nvs.read("keep", keep));
+    TEST_ASSERT_EQUAL_UINT32(7, keep);
+    TEST_ASSERT_EQUAL(ESP_ERR_NVS_NOT_FOUND, nvs.find("volume"));
+}
+
+TEST_CASE("导入成功后通知清空及导入的键", "[image]")
+{
+    MyNVS nvs("t_image_event", NVS_READWRITE);
+    clear(nvs);
+    std::vector<my_nvs_event_t> events;
+    int id = nvs.watch(nullptr, [&events](const my_nvs_event_t& event) {
+        events.push_back(event);
+    });
+    TEST_ASSERT_EQUAL(ESP_OK, nvs.import_namespace(test_image_start, test_image_size(), true));
+    nvs.unwatch(id);
+
+    // ERASE_ALL + 5个键的WRITE + COMMIT
+    TEST_ASSERT_EQUAL(7, events.size());
+    TEST_ASSERT_EQUAL(MY_NVS_EVENT_ERASE_ALL, events.front().type);
+    TEST_ASSERT_EQUAL(MY_NVS_EVENT_WRITE, events[1].type);
+    TEST_ASSERT_EQUAL_STRING("big", events[1].key);
+    TEST_ASSERT_EQUAL_STRING("volume", events[5].key);
+    TEST_ASSERT_EQUAL(MY_NVS_EVENT_COMMIT, events.back().type);
+}
@@ -0,0 +1,196 @@
+/*
+ *             Copyright [2025] [samllin]
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *        http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+
+#include <string>
+#include <vector>
+#include "unity.h"
+#include "my_nvs.hpp"
+#include "my_nvs_migration.hpp"
+
+static void clear(MyNVS& nvs)
+{
+    TEST_ASSERT_TRUE(nvs.opened());
+    TEST_ASSERT_EQUAL(ESP_OK, nvs.erase_all());
+    TEST_ASSERT_EQUAL(ESP_OK, nvs.commit());
+}
+
+static uint32_t schema_of(MyNVS& nvs)
+{
+    uint32_t version = 0;
+    nvs.read(MyNVS_Migration::SCHEMA_KEY, version);
+    return version;
+}
+
+TEST_CASE("迁移：重命名与删除", "[migration]")
+{
+    MyNVS nvs("t_mig_rename", NVS_READWRITE);
+    clear(nvs);
+    nvs.write("vol", static_cast<uint8_t>(200));
+    nvs.write("old", 1);
+
+    MyNVS_Migration migration;
+    migration.version(1).rename("vol", "volume").erase("old").rename("missing", "x");
+    TEST_ASSERT_EQUAL(ESP_OK, nvs.migrate(migration));
+    TEST_ASSERT_EQUAL_UINT32(1, schema_of(nvs));
+
+    uint8_t volume = 0;
+    TEST_ASSERT_EQUAL(ESP_OK, nvs.read("volume", volume));
+    TEST_ASSERT_EQUAL_UINT8(200, volume);
+    TEST_ASSERT_EQUAL(ESP_ERR_NVS_NOT_FOUND, nvs.find("vol"));
+    TEST_ASSERT_EQUAL(ESP_ERR_NVS_NOT_FOUND, nvs.find("old"));
+    TEST_ASSERT_EQUAL(ESP_ERR_NVS_NOT_FOUND, nvs.find("x"));
+
+    // 已是最新版本时不再执行
+    nvs.write("vol", static_cast<uint8_t>(1));
+    TEST_ASSERT_EQUAL(ESP_OK, nvs.migrate(migration));
+    TEST_ASSERT_EQUAL(ESP_OK, nvs.find("vol"));
+}
+
+TEST_CASE("迁移：修改类型", "[migration]")
+{
+    MyNVS nvs("t_mig_retype", NVS_READWRITE);
+    clear(nvs);
+    nvs.write("volume", static_cast<uint8_t>(200));
+    nvs.write("neg", static_cast<int16_t>(-5));
+    nvs.write("text", "text");
+
+    MyNVS_Migration migration;
+    migration.version(1).retype("volume", NVS_TYPE_U16).retype("neg", NVS_TYPE_I64).retype("text", NVS_TYPE_BLOB);
+    TEST_ASSERT_EQUAL(ESP_OK, nvs.migrate(migration));
+
+    uint16_t volume = 0;
+    int64_t neg = 0;
+    char text[8] = {};
+    size_t length = sizeof(text);
+    nvs_type_t type;
+    TEST_ASSERT_EQUAL(ESP_OK, nvs.read("volume", volume));
+    TEST_ASSERT_EQUAL_UINT16(200, volume);
+    TEST_ASSERT_EQUAL(ESP_OK, nvs.read("neg", neg));
+    TEST_ASSERT_TRUE(neg == -5);
+    TEST_ASSERT_EQUAL(ESP_OK, nvs.find("text", &type));
+    TEST_ASSERT_EQUAL(NVS_TYPE_BLOB, type);
+    TEST_ASSERT_EQUAL(ESP_OK, nvs.read("text", text, &length));
+    TEST_ASSERT_EQUAL(4, length);
+    TEST_ASSERT_EQUAL_MEMORY("text", text, 4);
+
+    // 超出目标类型范围时该版本整体不写入
+    MyNVS_Migration narrow;
+    narrow.version(2).rename("volume", "renamed").retype("neg", NVS_TYPE_U8);
+    TEST_ASSERT_EQUAL(ESP_ERR_INVALID_SIZE, nvs.migrate(narrow));
+    TEST_ASSERT_EQUAL_UINT32(1, schema_of(nvs));
+    TEST_ASSERT_EQUAL(ESP_OK, nvs.find("volume"));
+    TEST_ASSERT_EQUAL(ESP_ERR_NVS_NOT_FOUND, nvs.find("renamed"));
+}
+
+TEST_CASE("迁移：拆分", "[migration]")
+{
+    MyNVS nvs("t_mig_split", NVS_READWRITE);
+    clear(nvs);
+    nvs.write("rgb", static_cast<uint32_t>(0x00332211));
+    nvs.write("pair", "idname");
+
+    MyNVS_Migration migration;
+    migration.version(1).split("rgb", {{"r", NVS_TYPE_U8}, {"g", NVS_TYPE_U8}, {"b", NVS_TYPE_U8}})
+                        .split("pair", {{"id", NVS_TYPE_U16}, {"name", NVS_TYPE_STR}});
+    TEST_ASSERT_EQUAL(ESP_OK, nvs.migrate(migration));
+
+    uint8_t r = 0, g = 0, b = 0;
+    TEST_ASSERT_EQUAL(ESP_OK, nvs.read("r", r));
+    TEST_ASSERT_EQUAL(ESP_OK, nvs.read("g", g));
+    TEST_ASSERT_EQUAL(ESP_OK, nvs.read("b", b));
+    TEST_ASSERT_EQUAL_HEX8(0x11, r);
+    TEST_ASSERT_EQUAL_HEX8(0x22, g);
+    TEST_ASSERT_EQUAL_HEX8(0x33, b);
+    TEST_ASSERT_EQUAL(ESP_ERR_NVS_NOT_FOUND, nvs.find("rgb"));
+
+    uint16_t id = 0;
+    std::string name;
+    TEST_ASSERT_EQUAL(ESP_OK, nvs.read("id", id));
+    TEST_ASSERT_EQUAL_HEX16(('d' << 8) | 'i', id);
+    TEST_ASSERT_EQUAL(ESP_OK, nvs.read("name", name));
+    TEST_ASSERT_EQUAL_STRING("name", name.c_str());
+}
+
+TEST_CASE("迁移：合并", "[migration]")
+{
+    MyNVS nvs("t_mig_merge", NVS_READWRITE);
+    clear(nvs);
+    nvs.write("lo", static_cast<uint16_t>(0x0304));
+    nvs.write("hi", static_cast<uint16_t>(0x0102));
+    nvs.write("byte", static_cast<uint8_t>(0x7f));
+
+    MyNVS_Migration migration;
+    migration.version(1).merge({"lo", "hi"}, "both", NVS_TYPE_U32)
+             .version(2).merge({"byte"}, "wide", NVS_TYPE_U64);
+    TEST_ASSERT_EQUAL(ESP_OK, nvs.migrate(migration));
+    TEST_ASSERT_EQUAL_UINT32(2, schema_of(nvs));
+
+    uint32_t both = 0;
+    uint64_t wide = 0;
+    TEST_ASSERT_EQUAL(ESP_OK, nvs.read("both", both));
+    TEST_ASSERT_EQUAL_HEX32(0x01020304, both);
+    TEST_ASSERT_EQUAL(ESP_OK, nvs.read("wide", wide));
+    TEST_ASSERT_TRUE(wide == 0x7f);
+    TEST_ASSERT_EQUAL(ESP_ERR_NVS_NOT_FOUND, nvs.find("lo"));
+    TEST_ASSERT_EQUAL(ESP_ERR_NVS_NOT_FOUND, nvs.find("hi"));
+}
+
+TEST_CASE("迁移：版本号须严格递增", "[migration]")
+{
+    MyNVS_Migration migration;
+    migration.version(2).version(1);
+    TEST_ASSERT_FALSE(migration.valid());
+
+    MyNVS nvs("t_mig_invalid", NVS_READWRITE);
+    clear(nvs);
+    TEST_ASSERT_NOT_EQUAL(ESP_OK, nvs.migrate(migration));
+    TEST_ASSERT_EQUAL_UINT32(0, schema_of(nvs));
+}
+
+TEST_CASE("迁移：提交后逐键通知变更", "[migration]")
+{
+    MyNVS nvs("t_mig_event", NVS_READWRITE);
+    clear(nvs);
+    nvs.write("vol", static_cast<uint8_t>(1));
+    nvs.write("old", 2u);
+    nvs.commit();
+    std::vector<std::string> events;
+    int id = nvs.watch(nullptr, [&events](const my_nvs_event_t& event) {
+        events.push_back(std::to_string(event.type) + ":" + event.key);
+    });
+
+    MyNVS_Migration migration;
+    migration.version(1).rename("vol", "volume")
+             .version(2).erase("old");
+    TEST_ASSERT_EQUAL(ESP_OK, nvs.migrate(migration));
+    // 每个键只通知一次最终结果，最后通知提交
+    TEST_ASSERT_EQUAL(5, events.size());
+    TEST_ASSERT_EQUAL_STRING((std::to_string(MY_NVS_EVENT_WRITE) + ":" + MyNVS_Migration::SCHEMA_KEY).c_str(), events[0].c_str());
+    TEST_ASSERT_EQUAL_STRING((std::to_string(MY_NVS_EVENT_ERASE) + ":old").c_str(), events[1].c_str());
+    TEST_ASSERT_EQUAL_STRING((std::to_string(MY_NVS_EVENT_ERASE) + ":vol").c_str(), events[2].c_str());
+    TEST_ASSERT_EQUAL_STRING((std::to_string(MY_NVS_EVENT_WRITE) + ":volume").c_str(), events[3].c_str());
+    TEST_ASSERT_EQUAL_STRING((std::to_string(MY_NVS_EVENT_COMMIT) + ":").c_str(), events[4].c_str());
+
+    // 已是最新版本或步骤出错时不通知
+    events.clear();
+    TEST_ASSERT_EQUAL(ESP_OK, nvs.migrate(migration));
+    MyNVS_Migration failing;
+    failing.version(3).rename("volume", "v").retype("v", NVS_TYPE_STR);
+    TEST_ASSERT_NOT_EQUAL(ESP_OK, nvs.migrate(failing));
+    TEST_ASSERT_EQUAL(0, events.size());
+    TEST_ASSERT_EQUAL(ESP_OK, nvs.find("volume"));
+    nvs.unwatch(id);
+}
@@ -0,0 +1,78 @@
+/*
+ *             Copyright [2025] [samllin]
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *        http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+
+#include <array>
+#include <optional>
+#include <string>
+#include "unity.h"
+#include "my_nvs.hpp"
+#include "my_nvs_planner.hpp"
+
+TEST_CASE("字符串条目数为1个头条目加含'\\0'的数据条目", "[planner]")
+{
+    static_assert(MyNVS_Planner::ITEM_MAX_DATA == 4000);
+    TEST_ASSERT_EQUAL(2, MyNVS_Planner::string_entries(0));
+    TEST_ASSERT_EQUAL(2, MyNVS_Planner::string_entries(31));
+    TEST_ASSERT_EQUAL(3, MyNVS_Planner::string_entries(32));
+    TEST_ASSERT_EQUAL(3, MyNVS_Planner::string_entries(63));
+    TEST_ASSERT_EQUAL(1 + 126, MyNVS_Planner::string_entries(4000));
+}
+
+TEST_CASE("Blob条目数为数据条目加分块头及索引条目", "[planner]")
+{
+    // 分块数按多一个估算：ceil(length / 4000) + 1
+    TEST_ASSERT_EQUAL(0 + 1 + 1, MyNVS_Planner::blob_entries(0));
+    TEST_ASSERT_EQUAL(1 + 2 + 1, MyNVS_Planner::blob_entries(1));
+    TEST_ASSERT_EQUAL(4 + 2 + 1, MyNVS_Planner::blob_entries(100));
+    TEST_ASSERT_EQUAL(125 + 2 + 1, MyNVS_Planner::blob_entries(4000));
+    TEST_ASSERT_EQUAL(126 + 3 + 1, MyNVS_Planner::blob_entries(4001));
+}
+
+TEST_CASE("写入计划按类型累计条目数及跨页预留", "[planner]")
+{
+    MyNVS_Planner plan;
+    plan.add(static_cast<uint8_t>(1)).add(std::array<uint8_t, 8>{}).add(std::optional<int32_t>{});
+    TEST_ASSERT_EQUAL(2, plan.entries());
+    TEST_ASSERT_EQUAL(1, plan.max_span());
+    TEST_ASSERT_EQUAL(0, plan.reserve());
+
+    plan.add(std::array<uint8_t, 16>{}).add(std::string(100, 'x'));
+    TEST_ASSERT_EQUAL(2 + MyNVS_Planner::blob_entries(16) + MyNVS_Planner::string_entries(100), plan.entries());
+    TEST_ASSERT_EQUAL(MyNVS_Planner::string_entries(100), plan.max_span());
+    // 不足一页，最坏情况下浪费max_span - 1个条目
+    TEST_ASSERT_EQUAL(plan.max_span() - 1, plan.reserve());
+
+    plan.clear();
+    TEST_ASSERT_EQUAL(0, plan.entries());
+}
+
+TEST_CASE("can_fit报告中的预留比例与条目数一致", "[planner]")
+{
+    MyNVS nvs("t_planner", NVS_READWRITE);
+    TEST_ASSERT_TRUE(nvs.opened());
+    MyNVS_Planner plan;
+    plan.add_string(200).add_items(3);
+    my_nvs_capacity_t report{};
+    TEST_ASSERT_EQUAL(ESP_OK, nvs.can_fit(plan, &report));
+    TEST_ASSERT_EQUAL(plan.entries(), report.required_entries);
+    TEST_ASSERT_EQUAL(plan.reserve(), report.reserve_entries);
+    TEST_ASSERT_TRUE(report.available_entries > 0);
+    TEST_ASSERT_TRUE(report.reserve_ratio == static_cast<float>(report.reserve_entries) / report.available_entries);
+
+    MyNVS_Planner huge;
+    huge.add_blob(report.available_entries * MyNVS_Planner::ENTRY_SIZE);
+    TEST_ASSERT_EQUAL(ESP_ERR_NVS_NOT_ENOUGH_SPACE, nvs.can_fit(huge));
+}
@@ -0,0 +1,121 @@
+/*
+ *             Copyright [2025] [samllin]
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *        http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+
+#include <string>
+#include <vector>
+#include "unity.h"
+#include "my_nvs.hpp"
+#include "my_nvs_sharded.hpp"
+
+// 默认CONFIG_MAX_NAMESPACE为4，3个分片为其他用例留出余量
+#define SHARD_COUNT     3
+
+static void clear(MyNVS_Sharded& sharded)
+{
+    TEST_ASSERT_TRUE(sharded.opened());
+    for (const char* key : {"key0", "key1", "key2", "key3"}) {
+        auto nvs = sharded.shard(key);
+        TEST_ASSERT_EQUAL(ESP_OK, nvs->erase_all());
+        TEST_ASSERT_EQUAL(ESP_OK, nvs->commit());
+    }
+    sharded.reset_stats();
+}
+
+TEST_CASE("分片路由由键名决定，跨实例及超长键名截断后保持不变", "[sharded]")
+{
+    MyNVS_Sharded sharded("nvs", "t_shard", SHARD_COUNT, NVS_READWRITE);
+    TEST_ASSERT_TRUE(sharded.opened());
+    TEST_ASSERT_EQUAL(SHARD_COUNT, sharded.count());
+
+    // FNV-1a取模的固定结果，改变哈希会使已有数据无法找到
+    TEST_ASSERT_EQUAL(0, sharded.shard_of("key0"));
+    TEST_ASSERT_EQUAL(2, sharded.shard_of("key1"));
+    TEST_ASSERT_EQUAL(1, sharded.shard_of("key2"));
+    TEST_ASSERT_EQUAL(0, sharded.shard_of("key3"));
+    TEST_ASSERT_EQUAL(sharded.shard_of("a_very_long_key"), sharded.shard_of("a_very_long_key_name"));
+    clear(sharded);
+
+    for (const char* key : {"key0", "key1", "key2", "key3"}) {
+        TEST_ASSERT_EQUAL(ESP_OK, sharded.write(key, std::string(key)));
+    }
+    TEST_ASSERT_EQUAL(ESP_OK, sharded.commit_all());
+    // 键只存在于其所在分片
+    TEST_ASSERT_EQUAL(ESP_OK, sharded.shard("key1")->find("key1"));
+    TEST_ASSERT_EQUAL(ESP_ERR_NVS_NOT_FOUND, sharded.shard("key0")->find("key1"));
+
+    // 相同参数的另一实例共用槽位，路由一致
+    MyNVS_Sharded other("nvs", "t_shard", SHARD_COUNT, NVS_READONLY);
+    std::vector<size_t> shards(SHARD_COUNT, 0);
+    TEST_ASSERT_EQUAL(ESP_OK, other.for_each([&](size_t shard, const nvs_entry_info_t& info) {
+        TEST_ASSERT_EQUAL(other.shard_of(info.key), shard);
+        shards[shard]++;
+    }));
+    TEST_ASSERT_EQUAL(2, shards[0]);
+    TEST_ASSERT_EQUAL(1, shards[1]);
+    TEST_ASSERT_EQUAL(1, shards[2]);
+    for (const char* key : {"key0", "key1", "key2", "key3"}) {
+        std::string value;
+        TEST_ASSERT_EQUAL(ESP_OK, other.read(key, value));
+        TEST_ASSERT_EQUAL_STRING(key, value.c_str());
+    }
+}
+
+TEST_CASE("分片统计按分片计数读写并报告条目用量", "[sharded]")
+{
+    MyNVS_Sharded sharded("nvs", "t_shard", SHARD_COUNT, NVS_READWRITE);
+    clear(sharded);
+    sharded.write("key0", 1u);
+    sharded.write("key3", 2u);
+    sharded.write("key1", 3u);
+    uint32_t value = 0;
+    sharded.read("key0", value);
+    sharded.find("key2");
+    sharded.erase_key("key1");
+
+    std::vector<my_nvs_shard_stats_t> stats;
+    TEST_ASSERT_EQUAL(ESP_OK, sharded.stats(stats));
+    TEST_ASSERT_EQUAL(SHARD_COUNT, stats.size());
+    TEST_ASSERT_EQUAL_STRING("nvs", stats[0].partition.c_str());
+    TEST_ASSERT_EQUAL_STRING("t_shard0", stats[0].name_space.c_str());
+    TEST_ASSERT_EQUAL_UINT32(1, stats[0].reads);
+    TEST_ASSERT_EQUAL_UINT32(2, stats[0].writes);
+    TEST_ASSERT_EQUAL_UINT32(1, stats[1].reads);
+    TEST_ASSERT_EQUAL_UINT32(0, stats[1].writes);
+    TEST_ASSERT_EQUAL_UINT32(0, stats[2].reads);
+    TEST_ASSERT_EQUAL_UINT32(2, stats[2].writes);
+    TEST_ASSERT_EQUAL(2, stats[0].entries);
+    TEST_ASSERT_EQUAL(0, stats[2].entries);
+
+    sharded.reset_stats();
+    TEST_ASSERT_EQUAL(ESP_OK, sharded.stats(stats));
+    for (auto &shard : stats) {
+        TEST_ASSERT_EQUAL_UINT32(0, shard.reads);
+        TEST_ASSERT_EQUAL_UINT32(0, shard.writes);
+    }
+}
+
+TEST_CASE("没有分片时读写返回ESP_FAIL", "[sharded]")
+{
+    MyNVS_Sharded empty("nvs", "t_shard", 0, NVS_READWRITE);
+    TEST_ASSERT_FALSE(empty.opened());
+    TEST_ASSERT_EQUAL(0, empty.count());
+    TEST_ASSERT_TRUE(empty.shard("key") == nullptr);
+    uint32_t value = 0;
+    TEST_ASSERT_EQUAL(ESP_FAIL, empty.write("key", 1u));
+    TEST_ASSERT_EQUAL(ESP_FAIL, empty.read("key", value));
+    TEST_ASSERT_EQUAL(ESP_FAIL, empty.erase_key("key"));
+    TEST_ASSERT_EQUAL(ESP_FAIL, empty.commit_all());
+}
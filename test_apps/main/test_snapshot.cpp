@@ -0,0 +1,129 @@
+/*
+ *             Copyright [2025] [samllin]
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *        http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+
+#include <string>
+#include <vector>
+#include "unity.h"
+#include "my_nvs.hpp"
+#include "my_nvs_snapshot.hpp"
+
+static void clear(MyNVS& nvs)
+{
+    TEST_ASSERT_TRUE(nvs.opened());
+    TEST_ASSERT_EQUAL(ESP_OK, nvs.erase_all());
+    TEST_ASSERT_EQUAL(ESP_OK, nvs.commit());
+}
+
+TEST_CASE("快照在commit后发布新版本，旧快照仍可读取", "[snapshot]")
+{
+    MyNVS nvs("t_snap_publish", NVS_READWRITE);
+    clear(nvs);
+    nvs.write("value", 1u);
+    nvs.commit();
+    TEST_ASSERT_TRUE(nvs.snapshot() == nullptr);
+
+    TEST_ASSERT_EQUAL(ESP_OK, nvs.enable_snapshot());
+    auto first = nvs.snapshot();
+    TEST_ASSERT_TRUE(first != nullptr);
+    uint32_t version = nvs.snapshot_version();
+    uint32_t value = 0;
+    TEST_ASSERT_EQUAL(ESP_OK, first->read("value", value));
+    TEST_ASSERT_EQUAL_UINT32(1, value);
+
+    // 未提交的写入不发布
+    nvs.write("value", 2u);
+    TEST_ASSERT_EQUAL_UINT32(version, nvs.snapshot_version());
+    TEST_ASSERT_TRUE(nvs.snapshot() == first);
+
+    TEST_ASSERT_EQUAL(ESP_OK, nvs.commit());
+    TEST_ASSERT_TRUE(nvs.snapshot_version() != version);
+    auto second = nvs.snapshot();
+    TEST_ASSERT_TRUE(second != first);
+    TEST_ASSERT_EQUAL(ESP_OK, second->read("value", value));
+    TEST_ASSERT_EQUAL_UINT32(2, value);
+    TEST_ASSERT_EQUAL(ESP_OK, first->read("value", value));
+    TEST_ASSERT_EQUAL_UINT32(1, value);
+    int32_t mismatch = 0;
+    TEST_ASSERT_EQUAL(ESP_ERR_NVS_TYPE_MISMATCH, second->read("value", mismatch));
+    TEST_ASSERT_EQUAL(ESP_ERR_NVS_NOT_FOUND, second->find("missing"));
+}
+
+TEST_CASE("SnapshotReader仅在版本变化后重新获取，关闭后commit不再发布", "[snapshot]")
+{
+    MyNVS nvs("t_snap_reader", NVS_READWRITE);
+    clear(nvs);
+    nvs.write("value", static_cast<int16_t>(-1));
+    nvs.commit();
+    MyNVS_SnapshotReader reader(nvs);
+    TEST_ASSERT_TRUE(reader.get() == nullptr);
+
+    TEST_ASSERT_EQUAL(ESP_OK, nvs.enable_snapshot());
+    auto first = reader.get();
+    TEST_ASSERT_TRUE(first != nullptr);
+    TEST_ASSERT_TRUE(reader.get() == first);
+
+    nvs.write("value", static_cast<int16_t>(5));
+    nvs.commit();
+    auto second = reader.get();
+    TEST_ASSERT_TRUE(second != nullptr);
+    int16_t value = 0;
+    TEST_ASSERT_EQUAL(ESP_OK, second->read("value", value));
+    TEST_ASSERT_EQUAL(5, value);
+
+    TEST_ASSERT_EQUAL(ESP_OK, nvs.disable_snapshot());
+    TEST_ASSERT_TRUE(reader.get() == nullptr);
+    uint32_t version = nvs.snapshot_version();
+    nvs.write("value", static_cast<int16_t>(6));
+    TEST_ASSERT_EQUAL(ESP_OK, nvs.commit());
+    TEST_ASSERT_TRUE(nvs.snapshot() == nullptr);
+    TEST_ASSERT_EQUAL_UINT32(version, nvs.snapshot_version());
+}
+
+TEST_CASE("批量期间的通知按键合并，嵌套时在最外层end_batch发送", "[snapshot][watch]")
+{
+    MyNVS nvs("t_snap_batch", NVS_READWRITE);
+    clear(nvs);
+    nvs.write("b", 0u);
+    std::vector<my_nvs_event_t> events;
+    int id = nvs.watch(nullptr, [&events](const my_nvs_event_t& event) {
+        events.push_back(event);
+    });
+
+    nvs.begin_batch();
+    nvs.write("a", 1u);
+    nvs.write("a", 2u);
+    nvs.begin_batch();
+    nvs.erase_key("b");
+    nvs.end_batch();
+    TEST_ASSERT_EQUAL(0, events.size());
+    nvs.write("b", 3u);
+    nvs.commit();
+    nvs.commit();
+    nvs.end_batch();
+
+    // 同一键只保留最后一次事件，名字空间级事件只保留一次
+    TEST_ASSERT_EQUAL(3, events.size());
+    TEST_ASSERT_EQUAL(MY_NVS_EVENT_WRITE, events[0].type);
+    TEST_ASSERT_EQUAL_STRING("a", events[0].key);
+    TEST_ASSERT_EQUAL(MY_NVS_EVENT_WRITE, events[1].type);
+    TEST_ASSERT_EQUAL_STRING("b", events[1].key);
+    TEST_ASSERT_EQUAL(MY_NVS_EVENT_COMMIT, events[2].type);
+
+    // 批量结束后恢复逐次通知
+    nvs.write("a", 4u);
+    TEST_ASSERT_EQUAL(4, events.size());
+    nvs.unwatch(id);
+}
@@ -0,0 +1,132 @@
+/*
+ *             Copyright [2025] [samllin]
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *        http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+
+#include <array>
+#include <chrono>
+#include <optional>
+#include <vector>
+#include "unity.h"
+#include "my_nvs.hpp"
+
+static void clear(MyNVS& nvs)
+{
+    TEST_ASSERT_TRUE(nvs.opened());
+    TEST_ASSERT_EQUAL(ESP_OK, nvs.erase_all());
+    TEST_ASSERT_EQUAL(ESP_OK, nvs.commit());
+}
+
+TEST_CASE("不超过8字节的数组打包为u64，更大的数组存为Blob", "[types]")
+{
+    MyNVS nvs("t_types_arr", NVS_READWRITE);
+    clear(nvs);
+    const std::array<uint8_t, 4> small = {1, 2, 3, 4};
+    const std::array<int16_t, 4> packed = {-1, 2, -3, 4};
+    const std::array<float, 3> large = {0.5f, -1.25f, 3.0f};
+    TEST_ASSERT_EQUAL(ESP_OK, nvs.write("small", small));
+    TEST_ASSERT_EQUAL(ESP_OK, nvs.write("packed", packed));
+    TEST_ASSERT_EQUAL(ESP_OK, nvs.write("large", large));
+
+    nvs_type_t type = NVS_TYPE_ANY;
+    TEST_ASSERT_EQUAL(ESP_OK, nvs.find("small", &type));
+    TEST_ASSERT_EQUAL(NVS_TYPE_U64, type);
+    TEST_ASSERT_EQUAL(ESP_OK, nvs.find("packed", &type));
+    TEST_ASSERT_EQUAL(NVS_TYPE_U64, type);
+    TEST_ASSERT_EQUAL(ESP_OK, nvs.find("large", &type));
+    TEST_ASSERT_EQUAL(NVS_TYPE_BLOB, type);
+
+    std::array<uint8_t, 4> small_out{};
+    std::array<int16_t, 4> packed_out{};
+    std::array<float, 3> large_out{};
+    TEST_ASSERT_EQUAL(ESP_OK, nvs.read("small", small_out));
+    TEST_ASSERT_TRUE(small == small_out);
+    TEST_ASSERT_EQUAL(ESP_OK, nvs.read("packed", packed_out));
+    TEST_ASSERT_TRUE(packed == packed_out);
+    TEST_ASSERT_EQUAL(ESP_OK, nvs.read("large", large_out));
+    TEST_ASSERT_TRUE(large == large_out);
+
+    // Blob长度与数组大小不一致时不修改目标
+    std::array<float, 4> wrong = {9.0f, 9.0f, 9.0f, 9.0f};
+    TEST_ASSERT_EQUAL(ESP_ERR_NVS_INVALID_LENGTH, nvs.read("large", wrong));
+    TEST_ASSERT_TRUE(wrong[0] == 9.0f);
+}
+
+TEST_CASE("vector存为Blob，空容器写入零长度Blob", "[types]")
+{
+    MyNVS nvs("t_types_vec", NVS_READWRITE);
+    clear(nvs);
+    const std::vector<uint16_t> values = {1, 300, 65535};
+    TEST_ASSERT_EQUAL(ESP_OK, nvs.write("values", values));
+    TEST_ASSERT_EQUAL(ESP_OK, nvs.write("empty", std::vector<uint32_t>{}));
+
+    std::vector<uint16_t> out;
+    TEST_ASSERT_EQUAL(ESP_OK, nvs.read("values", out));
+    TEST_ASSERT_TRUE(values == out);
+    std::vector<uint32_t> empty = {7};
+    TEST_ASSERT_EQUAL(ESP_OK, nvs.read("empty", empty));
+    TEST_ASSERT_TRUE(empty.empty());
+
+    // 长度不是元素大小的整数倍
+    std::vector<uint32_t> wrong;
+    TEST_ASSERT_EQUAL(ESP_ERR_NVS_INVALID_LENGTH, nvs.read("values", wrong));
+}
+
+TEST_CASE("optional为空时删除键，键不存在时读为空值", "[types]")
+{
+    MyNVS nvs("t_types_opt", NVS_READWRITE);
+    clear(nvs);
+    std::optional<int32_t> value = -7;
+    TEST_ASSERT_EQUAL(ESP_OK, nvs.write("opt", value));
+    std::optional<int32_t> out;
+    TEST_ASSERT_EQUAL(ESP_OK, nvs.read("opt", out));
+    TEST_ASSERT_TRUE(out.has_value());
+    TEST_ASSERT_EQUAL_INT32(-7, *out);
+
+    value.reset();
+    TEST_ASSERT_EQUAL(ESP_OK, nvs.write("opt", value));
+    TEST_ASSERT_EQUAL(ESP_ERR_NVS_NOT_FOUND, nvs.find("opt"));
+    TEST_ASSERT_EQUAL(ESP_OK, nvs.read("opt", out));
+    TEST_ASSERT_FALSE(out.has_value());
+    // 键本就不存在时写入空值同样成功
+    TEST_ASSERT_EQUAL(ESP_OK, nvs.write("opt", value));
+
+    // 类型不匹配等其他错误照常返回，不当作空值
+    nvs.write("text", "text");
+    out = 1;
+    TEST_ASSERT_EQUAL(ESP_ERR_NVS_TYPE_MISMATCH, nvs.read("text", out));
+    TEST_ASSERT_TRUE(out.has_value());
+}
+
+TEST_CASE("chrono时长与时间点按计数值存储", "[types]")
+{
+    using namespace std::chrono;
+    MyNVS nvs("t_types_chrono", NVS_READWRITE);
+    clear(nvs);
+    TEST_ASSERT_EQUAL(ESP_OK, nvs.write("timeout", milliseconds(1500)));
+    const auto stamp = system_clock::time_point(seconds(1700000000));
+    TEST_ASSERT_EQUAL(ESP_OK, nvs.write("stamp", stamp));
+
+    milliseconds timeout{};
+    TEST_ASSERT_EQUAL(ESP_OK, nvs.read("timeout", timeout));
+    TEST_ASSERT_TRUE(timeout == milliseconds(1500));
+    system_clock::time_point stamp_out{};
+    TEST_ASSERT_EQUAL(ESP_OK, nvs.read("stamp", stamp_out));
+    TEST_ASSERT_TRUE(stamp == stamp_out);
+
+    // 存储的是rep计数值，可按同一rep类型直接读取
+    milliseconds::rep raw = 0;
+    TEST_ASSERT_EQUAL(ESP_OK, nvs.read("timeout", raw));
+    TEST_ASSERT_EQUAL(1500, raw);
+}
@@ -0,0 +1,160 @@
+/*
+ *             Copyright [2025] [samllin]
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *        http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+
+#include "sdkconfig.h"
+
+#if CONFIG_MYNVS_WARM_CACHE
+#include "unity.h"
+#include "my_nvs.hpp"
+#include "my_nvs_warm_cache.hpp"
+
+#define GEN_NAMESPACE   "mynvs_wcgen"
+
+static void clear(MyNVS& nvs)
+{
+    TEST_ASSERT_TRUE(nvs.opened());
+    TEST_ASSERT_EQUAL(ESP_OK, nvs.erase_all());
+    TEST_ASSERT_EQUAL(ESP_OK, nvs.commit());
+}
+
+// Flash中记录的名字空间代数，无记录时返回0
+static uint32_t flash_generation(const char* name_space)
+{
+    nvs_handle_t handle;
+    uint32_t generation = 0;
+    if (nvs_open_from_partition("nvs", GEN_NAMESPACE, NVS_READONLY, &handle) == ESP_OK) {
+        nvs_get_u32(handle, name_space, &generation);
+        nvs_close(handle);
+    }
+    return generation;
+}
+
+static void set_flash_generation(const char* name_space, uint32_t generation)
+{
+    nvs_handle_t handle;
+    TEST_ASSERT_EQUAL(ESP_OK, nvs_open_from_partition("nvs", GEN_NAMESPACE, NVS_READWRITE, &handle));
+    if (generation == 0) {
+        nvs_erase_key(handle, name_space);
+    } else {
+        TEST_ASSERT_EQUAL(ESP_OK, nvs_set_u32(handle, name_space, generation));
+    }
+    TEST_ASSERT_EQUAL(ESP_OK, nvs_commit(handle));
+    nvs_close(handle);
+}
+
+TEST_CASE("写入、删除及清空名字空间使缓存条目失效", "[warm_cache]")
+{
+    MyNVS nvs("t_wc_inval", NVS_READWRITE);
+    clear(nvs);
+    TEST_ASSERT_EQUAL(ESP_OK, nvs.write("a", 1));
+    TEST_ASSERT_EQUAL(ESP_OK, nvs.write("b", 2u));
+    TEST_ASSERT_EQUAL(ESP_OK, nvs.commit());
+
+    int a = 0;
+    uint32_t b = 0;
+    TEST_ASSERT_EQUAL(ESP_OK, nvs.read("a", a));
+    auto before = MyNVS_WarmCache::stats();
+    TEST_ASSERT_EQUAL(ESP_OK, nvs.read("a", a));
+    TEST_ASSERT_EQUAL(1, a);
+    TEST_ASSERT_EQUAL(before.hits + 1, MyNVS_WarmCache::stats().hits);
+
+    // 写入后读到新值（未命中后重新填充）
+    TEST_ASSERT_EQUAL(ESP_OK, nvs.write("a", 7));
+    before = MyNVS_WarmCache::stats();
+    TEST_ASSERT_EQUAL(ESP_OK, nvs.read("a", a));
+    TEST_ASSERT_EQUAL(7, a);
+    TEST_ASSERT_EQUAL(before.misses + 1, MyNVS_WarmCache::stats().misses);
+
+    // 同名键以其他类型读取不命中
+    int16_t narrow = 0;
+    before = MyNVS_WarmCache::stats();
+    TEST_ASSERT_NOT_EQUAL(ESP_OK, nvs.read("a", narrow));
+    TEST_ASSERT_EQUAL(before.hits, MyNVS_WarmCache::stats().hits);
+
+    TEST_ASSERT_EQUAL(ESP_OK, nvs.erase_key("a"));
+    TEST_ASSERT_EQUAL(ESP_ERR_NVS_NOT_FOUND, nvs.read("a", a));
+
+    TEST_ASSERT_EQUAL(ESP_OK, nvs.read("b", b));
+    TEST_ASSERT_EQUAL(ESP_OK, nvs.erase_all());
+    TEST_ASSERT_EQUAL(ESP_ERR_NVS_NOT_FOUND, nvs.read("b", b));
+    TEST_ASSERT_EQUAL(ESP_OK, nvs.commit());
+}
+
+TEST_CASE("打开名字空间时只读取代数，由提交及关闭时的提交写入", "[warm_cache]")
+{
+    set_flash_generation("t_wc_ro", 0);
+    {
+        MyNVS nvs("t_wc_ro", NVS_READONLY);
+        TEST_ASSERT_TRUE(nvs.opened());
+        TEST_ASSERT_EQUAL(ESP_OK, nvs.commit());
+    }
+    TEST_ASSERT_EQUAL(0, flash_generation("t_wc_ro"));
+
+    set_flash_generation("t_wc_rw", 0);
+    {
+        MyNVS nvs("t_wc_rw", NVS_READWRITE);
+        TEST_ASSERT_EQUAL(0, flash_generation("t_wc_rw"));
+        // 无记录时即使没有修改，首次提交也写入代数
+        TEST_ASSERT_EQUAL(ESP_OK, nvs.commit());
+        TEST_ASSERT_EQUAL(1, flash_generation("t_wc_rw"));
+        TEST_ASSERT_EQUAL(ESP_OK, nvs.commit());
+        TEST_ASSERT_EQUAL(1, flash_generation("t_wc_rw"));
+        // 有修改但未提交，由最后一个实例关闭时的提交递增
+        TEST_ASSERT_EQUAL(ESP_OK, nvs.write("v", 3));
+    }
+    TEST_ASSERT_EQUAL(2, flash_generation("t_wc_rw"));
+}
+
+TEST_CASE("Flash代数与缓存记录不一致时丢弃该名字空间的条目", "[warm_cache]")
+{
+    {
+        MyNVS nvs("t_wc_gen", NVS_READWRITE);
+        clear(nvs);
+        TEST_ASSERT_EQUAL(ESP_OK, nvs.write("v", 10));
+        TEST_ASSERT_EQUAL(ESP_OK, nvs.commit());
+        int v = 0;
+        TEST_ASSERT_EQUAL(ESP_OK, nvs.read("v", v));
+    }
+    // 代数一致：重新打开后直接命中
+    {
+        MyNVS nvs("t_wc_gen", NVS_READONLY);
+        auto before = MyNVS_WarmCache::stats();
+        int v = 0;
+        TEST_ASSERT_EQUAL(ESP_OK, nvs.read("v", v));
+        TEST_ASSERT_EQUAL(10, v);
+        TEST_ASSERT_EQUAL(before.hits + 1, MyNVS_WarmCache::stats().hits);
+    }
+    // 绕过MyNVS修改值并改变代数，模拟缓存之外的写入
+    uint32_t generation = flash_generation("t_wc_gen");
+    TEST_ASSERT_NOT_EQUAL(0, generation);
+    nvs_handle_t handle;
+    TEST_ASSERT_EQUAL(ESP_OK, nvs_open_from_partition("nvs", "t_wc_gen", NVS_READWRITE, &handle));
+    TEST_ASSERT_EQUAL(ESP_OK, nvs_set_i32(handle, "v", 20));
+    TEST_ASSERT_EQUAL(ESP_OK, nvs_commit(handle));
+    nvs_close(handle);
+    set_flash_generation("t_wc_gen", generation + 5);
+    {
+        MyNVS nvs("t_wc_gen", NVS_READONLY);
+        auto before = MyNVS_WarmCache::stats();
+        int v = 0;
+        TEST_ASSERT_EQUAL(ESP_OK, nvs.read("v", v));
+        TEST_ASSERT_EQUAL(20, v);
+        TEST_ASSERT_EQUAL(before.hits, MyNVS_WarmCache::stats().hits);
+        TEST_ASSERT_EQUAL(before.misses + 1, MyNVS_WarmCache::stats().misses);
+    }
+}
+
+#endif
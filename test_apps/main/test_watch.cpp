@@ -0,0 +1,137 @@
+/*
+ *             Copyright [2025] [samllin]
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *        http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+
+#include <string>
+#include <tuple>
+#include <vector>
+#include "unity.h"
+#include "my_nvs.hpp"
+
+static void clear(MyNVS& nvs)
+{
+    TEST_ASSERT_TRUE(nvs.opened());
+    TEST_ASSERT_EQUAL(ESP_OK, nvs.erase_all());
+    TEST_ASSERT_EQUAL(ESP_OK, nvs.commit());
+}
+
+// 记录收到的事件，键级事件记为"W:键名"/"E:键名"，名字空间级事件记为"ERASE_ALL"/"COMMIT"
+struct recorder_t {
+    std::vector<std::string> events;
+    my_nvs_watch_cb_t callback() {
+        return [this](const my_nvs_event_t& event) {
+            switch (event.type) {
+                case MY_NVS_EVENT_WRITE:     events.push_back(std::string("W:") + event.key); break;
+                case MY_NVS_EVENT_ERASE:     events.push_back(std::string("E:") + event.key); break;
+                case MY_NVS_EVENT_ERASE_ALL: events.push_back("ERASE_ALL"); break;
+                case MY_NVS_EVENT_COMMIT:    events.push_back("COMMIT"); break;
+            }
+        };
+    }
+};
+
+TEST_CASE("订阅按前缀匹配键级事件，名字空间级事件通知全部订阅", "[watch]")
+{
+    MyNVS nvs("t_watch_prefix", NVS_READWRITE);
+    clear(nvs);
+    recorder_t all, cfg;
+    int all_id = nvs.watch(nullptr, all.callback());
+    int cfg_id = nvs.watch("cfg_", cfg.callback());
+    TEST_ASSERT_TRUE(all_id >= 0);
+    TEST_ASSERT_TRUE(cfg_id >= 0);
+
+    nvs.write("cfg_a", 1u);
+    nvs.write("other", 2u);
+    nvs.erase_key("cfg_a");
+    nvs.commit();
+    TEST_ASSERT_EQUAL(4, all.events.size());
+    TEST_ASSERT_EQUAL(3, cfg.events.size());
+    TEST_ASSERT_EQUAL_STRING("W:cfg_a", cfg.events[0].c_str());
+    TEST_ASSERT_EQUAL_STRING("E:cfg_a", cfg.events[1].c_str());
+    TEST_ASSERT_EQUAL_STRING("COMMIT", cfg.events[2].c_str());
+
+    // 失败的写入不通知
+    TEST_ASSERT_EQUAL(ESP_ERR_NVS_NOT_FOUND, nvs.erase_key("cfg_missing"));
+    TEST_ASSERT_EQUAL(3, cfg.events.size());
+
+    nvs.unwatch(cfg_id);
+    nvs.erase_all();
+    TEST_ASSERT_EQUAL(3, cfg.events.size());
+    TEST_ASSERT_EQUAL_STRING("ERASE_ALL", all.events.back().c_str());
+    nvs.unwatch(all_id);
+}
+
+TEST_CASE("read_all逐键返回结果，失败的键不修改目标", "[watch][batch]")
+{
+    MyNVS nvs("t_batch_read", NVS_READWRITE);
+    clear(nvs);
+    nvs.write("a", static_cast<uint8_t>(1));
+    nvs.write("c", "text");
+
+    uint8_t a = 0;
+    int32_t b = -1;
+    int16_t c = -1;
+    auto errs = nvs.read_all(std::tie(a, b, c), "a", "b", "c");
+    TEST_ASSERT_EQUAL(ESP_OK, errs[0]);
+    TEST_ASSERT_EQUAL_UINT8(1, a);
+    TEST_ASSERT_EQUAL(ESP_ERR_NVS_NOT_FOUND, errs[1]);
+    TEST_ASSERT_EQUAL_INT32(-1, b);
+    TEST_ASSERT_EQUAL(ESP_ERR_NVS_TYPE_MISMATCH, errs[2]);
+    TEST_ASSERT_EQUAL(-1, c);
+
+    // 空键名只影响该键
+    auto key_errs = nvs.read_all(std::tie(b, a), "", "a");
+    TEST_ASSERT_EQUAL(ESP_ERR_INVALID_ARG, key_errs[0]);
+    TEST_ASSERT_EQUAL(ESP_OK, key_errs[1]);
+}
+
+TEST_CASE("write_all逐键返回结果，只通知写入成功的键", "[watch][batch]")
+{
+    {
+        MyNVS nvs("t_batch_write", NVS_READWRITE);
+        clear(nvs);
+        recorder_t recorder;
+        int id = nvs.watch(nullptr, recorder.callback());
+
+        const float ratio = 0.5f;
+        auto errs = nvs.write_all(std::make_tuple(static_cast<int8_t>(-3), ratio, true),
+            "i8", "", "a_very_long_key_name");
+        TEST_ASSERT_EQUAL(ESP_OK, errs[0]);
+        TEST_ASSERT_EQUAL(ESP_ERR_INVALID_ARG, errs[1]);
+        TEST_ASSERT_EQUAL(ESP_OK, errs[2]);
+        // 超长键名按NVS长度截断写入，通知中的键名与实际写入的一致
+        TEST_ASSERT_EQUAL(2, recorder.events.size());
+        TEST_ASSERT_EQUAL_STRING("W:i8", recorder.events[0].c_str());
+        TEST_ASSERT_EQUAL_STRING("W:a_very_long_key", recorder.events[1].c_str());
+
+        int8_t i8 = 0;
+        bool flag = false;
+        auto read_errs = nvs.read_all(std::tie(i8, flag), "i8", "a_very_long_key");
+        TEST_ASSERT_EQUAL(ESP_OK, read_errs[0]);
+        TEST_ASSERT_EQUAL(-3, i8);
+        TEST_ASSERT_EQUAL(ESP_OK, read_errs[1]);
+        TEST_ASSERT_TRUE(flag);
+        nvs.unwatch(id);
+        TEST_ASSERT_EQUAL(ESP_OK, nvs.commit());
+    }
+
+    // 只读打开时整批失败，每个键都返回加锁结果
+    MyNVS readonly("t_batch_write", NVS_READONLY);
+    TEST_ASSERT_TRUE(readonly.opened());
+    auto errs = readonly.write_all(std::make_tuple(1u, 2u), "x", "y");
+    TEST_ASSERT_EQUAL(ESP_FAIL, errs[0]);
+    TEST_ASSERT_EQUAL(ESP_FAIL, errs[1]);
+    TEST_ASSERT_EQUAL(ESP_ERR_NVS_NOT_FOUND, readonly.find("x"));
+}
@@ -0,0 +1,178 @@
+#!/usr/bin/env python3
+#
+#             Copyright [2025] [samllin]
+# Licensed under the Apache License, Version 2.0 (the "License");
+# you may not use this file except in compliance with the License.
+# You may obtain a copy of the License at
+#
+#        http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing, software
+# distributed under the License is distributed on an "AS IS" BASIS,
+# WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+# See the License for the specific language governing permissions and
+# limitations under the License.
+#
+"""
+MyNVS 名字空间镜像工具（格式见 include/my_nvs_image.hpp）
+
+生成镜像：
+    mynvs_image.py build values.csv image.bin
+查看镜像：
+    mynvs_image.py dump image.bin
+
+CSV格式（首行为表头，#开头的行为注释）：
+    key,type,value
+    volume,u8,30
+    offset,i32,-12
+    name,string,device-01
+    calib,hex,0a0b0c0d
+    cert,file,certs/device.der
+类型：u8 i8 u16 i16 u32 i32 u64 i64 string hex(Blob十六进制) base64(Blob) file(Blob文件内容)
+"""
+
+import argparse
+import base64
+import csv
+import os
+import struct
+import sys
+import zlib
+
+IMAGE_MAGIC = 0x49564E4D
+IMAGE_VERSION = 2
+KEY_MAX_LENGTH = 15
+HEADER = struct.Struct('<IHHII')
+ENTRY = struct.Struct('<BB')
+
+NVS_TYPE_STR = 0x21
+NVS_TYPE_BLOB = 0x42
+INTEGER_TYPES = {
+    'u8': (0x01, '<B'), 'i8': (0x11, '<b'),
+    'u16': (0x02, '<H'), 'i16': (0x12, '<h'),
+    'u32': (0x04, '<I'), 'i32': (0x14, '<i'),
+    'u64': (0x08, '<Q'), 'i64': (0x18, '<q'),
+}
+TYPE_NAMES = {code: name for name, (code, _) in INTEGER_TYPES.items()}
+TYPE_NAMES.update({NVS_TYPE_STR: 'string', NVS_TYPE_BLOB: 'blob'})
+
+
+def encode_value(type_name, value, base_dir):
+    if type_name in INTEGER_TYPES:
+        code, fmt = INTEGER_TYPES[type_name]
+        return code, struct.pack(fmt, int(value, 0))
+    if type_name == 'string':
+        return NVS_TYPE_STR, value.encode('utf-8') + b'\0'
+    if type_name == 'hex':
+        return NVS_TYPE_BLOB, bytes.fromhex(value)
+    if type_name == 'base64':
+        return NVS_TYPE_BLOB, base64.b64decode(value)
+    if type_name == 'file':
+        with open(os.path.join(base_dir, value), 'rb') as fp:
+            return NVS_TYPE_BLOB, fp.read()
+    raise ValueError('不支持的类型: %s' % type_name)
+
+
+def image_crc(header, payload):
+    # 覆盖头部crc之前的12字节及全部条目，与my_nvs_image.cpp一致
+    return zlib.crc32(bytes(payload), zlib.crc32(header[:HEADER.size - 4])) & 0xFFFFFFFF
+
+
+def build_image(entries):
+    payload = bytearray()
+    for key, code, value in entries:
+        key_bytes = key.encode('ascii')
+        if not key_bytes or len(key_bytes) > KEY_MAX_LENGTH:
+            raise ValueError('键名长度须为1~%d: %s' % (KEY_MAX_LENGTH, key))
+        payload += ENTRY.pack(code, len(key_bytes)) + key_bytes
+        payload += struct.pack('<I', len(value)) + value
+    if len(entries) > 0xFFFF:
+        raise ValueError('条目过多: %d' % len(entries))
+    header = HEADER.pack(IMAGE_MAGIC, IMAGE_VERSION, len(entries), len(payload), 0)
+    return HEADER.pack(IMAGE_MAGIC, IMAGE_VERSION, len(entries), len(payload), image_crc(header, payload)) + bytes(payload)
+
+
+def parse_image(data):
+    if len(data) < HEADER.size:
+        raise ValueError('镜像过短')
+    magic, version, count, length, crc = HEADER.unpack_from(data)
+    if magic != IMAGE_MAGIC:
+        raise ValueError('镜像标识错误: 0x%08x' % magic)
+    if version != IMAGE_VERSION:
+        raise ValueError('不支持的镜像版本: %d' % version)
+    payload = data[HEADER.size:]
+    if len(payload) != length:
+        raise ValueError('镜像长度不匹配: %d/%d' % (length, len(payload)))
+    if image_crc(data[:HEADER.size], payload) != crc:
+        raise ValueError('镜像CRC校验失败')
+    entries = []
+    offset = 0
+    for _ in range(count):
+        code, key_length = ENTRY.unpack_from(payload, offset)
+        offset += ENTRY.size
+        key = payload[offset:offset + key_length].decode('ascii')
+        offset += key_length
+        (value_length,) = struct.unpack_from('<I', payload, offset)
+        offset += 4
+        entries.append((key, code, payload[offset:offset + value_length]))
+        offset += value_length
+    if offset != length:
+        raise ValueError('镜像条目数与长度不匹配')
+    return entries
+
+
+def format_value(code, value):
+    name = TYPE_NAMES.get(code)
+    if name in INTEGER_TYPES:
+        return str(struct.unpack(INTEGER_TYPES[name][1], value)[0])
+    if code == NVS_TYPE_STR:
+        return repr(value[:-1].decode('utf-8', errors='replace'))
+    return value.hex() if len(value) <= 32 else '%s... (%d bytes)' % (value[:32].hex(), len(value))
+
+
+def cmd_build(args):
+    base_dir = os.path.dirname(os.path.abspath(args.csv))
+    entries = []
+    with open(args.csv, newline='', encoding='utf-8') as fp:
+        rows = [row for row in csv.reader(fp) if row and not row[0].lstrip().startswith('#')]
+    for row in rows[1:]:
+        if len(row) < 3:
+            raise ValueError('CSV行格式错误: %s' % ','.join(row))
+        key, type_name, value = row[0].strip(), row[1].strip().lower(), ','.join(row[2:])
+        code, encoded = encode_value(type_name, value, base_dir)
+        entries.append((key, code, encoded))
+    image = build_image(entries)
+    with open(args.output, 'wb') as fp:
+        fp.write(image)
+    print('已生成镜像: %s，%d个条目，%d字节' % (args.output, len(entries), len(image)))
+    return 0
+
+
+def cmd_dump(args):
+    with open(args.image, 'rb') as fp:
+        entries = parse_image(fp.read())
+    for key, code, value in entries:
+        print('%-15s %-7s %s' % (key, TYPE_NAMES.get(code, '0x%02x' % code), format_value(code, value)))
+    return 0
+
+
+def main():
+    parser = argparse.ArgumentParser(description='MyNVS 名字空间镜像工具')
+    sub = parser.add_subparsers(dest='command', required=True)
+    build = sub.add_parser('build', help='由CSV生成镜像')
+    build.add_argument('csv')
+    build.add_argument('output')
+    build.set_defaults(func=cmd_build)
+    dump = sub.add_parser('dump', help='查看镜像内容')
+    dump.add_argument('image')
+    dump.set_defaults(func=cmd_dump)
+    args = parser.parse_args()
+    try:
+        return args.func(args)
+    except (OSError, ValueError, struct.error) as err:
+        print('错误: %s' % err, file=sys.stderr)
+        return 1
+
+
+if __name__ == '__main__':
+    sys.exit(main())
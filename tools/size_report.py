@@ -0,0 +1,134 @@
+#!/usr/bin/env python3
+#
+#             Copyright [2025] [samllin]
+# Licensed under the Apache License, Version 2.0 (the "License");
+# you may not use this file except in compliance with the License.
+# You may obtain a copy of the License at
+#
+#        http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing, software
+# distributed under the License is distributed on an "AS IS" BASIS,
+# WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+# See the License for the specific language governing permissions and
+# limitations under the License.
+#
+"""
+MyNVS 代码体积报告
+
+解析链接器生成的map文件，统计：
+  1. 组件库(lib<组件名>.a，由CMake通过--archive传入)自身的体积；
+  2. 散落在其他目标文件中的MyNVS模板实例(符号名含MyNVS)的体积；
+  3. 整个镜像的体积。
+首次运行(或指定--save)时保存为基线，之后每次运行与基线对比，输出变化量。
+"""
+
+import argparse
+import json
+import os
+import re
+import sys
+
+# 输出段归类
+CATEGORIES = (
+    ('iram', ('.iram', '.iram1', '.vectors')),
+    ('text', ('.text', '.literal', '.flash.text')),
+    ('rodata', ('.rodata', '.flash.rodata', '.dram1.rodata')),
+    ('data', ('.data', '.dram', '.dram1')),
+    ('bss', ('.bss', '.sbss', 'COMMON', '.noinit')),
+)
+
+# 输入段行：" .text.xxx   0x400d1234   0x4c  path/libmy_nvs.a(my_nvs.cpp.obj)"
+# 段名过长时，地址、大小与文件位于下一行
+RE_FULL = re.compile(r'^ (\S+)\s+0x([0-9a-fA-F]+)\s+0x([0-9a-fA-F]+)\s+(\S.*)$')
+RE_NAME = re.compile(r'^ (\S+)$')
+RE_REST = re.compile(r'^\s+0x([0-9a-fA-F]+)\s+0x([0-9a-fA-F]+)\s+(\S.*)$')
+
+
+def classify(section):
+    for name, prefixes in CATEGORIES:
+        for prefix in prefixes:
+            if section == prefix or section.startswith(prefix + '.') or section.startswith(prefix + '_'):
+                return name
+    return None
+
+
+def parse_map(path, archive):
+    result = {
+        'component': {name: 0 for name, _ in CATEGORIES},
+        'templates': {name: 0 for name, _ in CATEGORIES},
+        'image': {name: 0 for name, _ in CATEGORIES},
+    }
+    in_memory_map = False
+    pending = None
+    with open(path, 'r', errors='replace') as fp:
+        for line in fp:
+            line = line.rstrip('\n')
+            if not in_memory_map:
+                # 跳过"Discarded input sections"，只统计真正进入镜像的段
+                in_memory_map = line.startswith('Linker script and memory map')
+                continue
+            match = RE_FULL.match(line)
+            if match:
+                section, addr, size, source = match.groups()
+            elif pending is not None and RE_REST.match(line):
+                addr, size, source = RE_REST.match(line).groups()
+                section, pending = pending, None
+            else:
+                name = RE_NAME.match(line)
+                pending = name.group(1) if name else None
+                continue
+            pending = None
+            category = classify(section)
+            size = int(size, 16)
+            if category is None or size == 0 or int(addr, 16) == 0:
+                continue
+            result['image'][category] += size
+            if archive in source:
+                result['component'][category] += size
+            elif 'MyNVS' in section or '5MyNVS' in section:
+                result['templates'][category] += size
+    return result
+
+
+def print_report(current, baseline):
+    print('%-10s %-8s %10s %10s %10s' % ('scope', 'category', 'baseline', 'current', 'delta'))
+    for scope in ('component', 'templates', 'image'):
+        total_base = total_curr = 0
+        for name, _ in CATEGORIES:
+            curr = current[scope][name]
+            base = baseline[scope][name] if baseline else curr
+            total_base += base
+            total_curr += curr
+            print('%-10s %-8s %10d %10d %+10d' % (scope, name, base, curr, curr - base))
+        print('%-10s %-8s %10d %10d %+10d' % (scope, 'total', total_base, total_curr, total_curr - total_base))
+
+
+def main():
+    parser = argparse.ArgumentParser(description='MyNVS 代码体积报告')
+    parser.add_argument('--map', required=True, help='链接器map文件')
+    parser.add_argument('--baseline', required=True, help='基线文件(json)，不存在时自动创建')
+    parser.add_argument('--archive', default='libmy_nvs.a', help='组件静态库名')
+    parser.add_argument('--save', action='store_true', help='将本次结果保存为新的基线')
+    args = parser.parse_args()
+
+    if not os.path.exists(args.map):
+        print('map文件不存在: %s，请先编译工程' % args.map, file=sys.stderr)
+        return 1
+    current = parse_map(args.map, args.archive)
+
+    baseline = None
+    if os.path.exists(args.baseline) and not args.save:
+        with open(args.baseline, 'r') as fp:
+            baseline = json.load(fp)
+    print_report(current, baseline)
+
+    if baseline is None:
+        with open(args.baseline, 'w') as fp:
+            json.dump(current, fp, indent=2)
+        print('已保存基线: %s' % args.baseline)
+    return 0
+
+
+if __name__ == '__main__':
+    sys.exit(main())